@@ -0,0 +1,285 @@
+#ifndef ARBOL_DE_POSICIONES_H_
+#define ARBOL_DE_POSICIONES_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cassert>
+using namespace std;
+
+/**
+ * Enlaces de un nodo en un ArbolDePosiciones: van dentro del nodo, así
+ * que el árbol no pide memoria.
+ */
+template<typename Nodo>
+struct EnlacesDePosicion {
+	Nodo* izquierdo;
+	Nodo* derecho;
+	Nodo* padre;
+	uint32_t prioridad;
+	// Nodos y nodos activos del subárbol, el propio incluido
+	int cantidad;
+	int activos;
+	EnlacesDePosicion(): izquierdo(NULL), derecho(NULL), padre(NULL), prioridad(0),
+		cantidad(1), activos(1){}
+};
+
+/**
+ * Árbol de posiciones sobre una secuencia de nodos: un treap sin claves,
+ * ordenado por la posición de cada nodo en la secuencia, que cuenta en
+ * cada subárbol cuántos nodos hay y cuántos están activos. Con eso
+ * responde la posición de un nodo (entre todos o entre los activos) y el
+ * nodo de una posición en O(log n) esperado, y también cuesta eso
+ * insertar, borrar o cambiar el estado de un nodo.
+ *
+ * Nodo tiene que tener un campo posicion de tipo EnlacesDePosicion<Nodo>
+ * y un campo bool pausado; si se cambia pausado hay que avisar con
+ * actualizarEstado.
+ */
+template<typename Nodo>
+class ArbolDePosiciones {
+
+  public:
+
+	ArbolDePosiciones() noexcept: raiz(NULL), semilla(0x9E3779B9u){}
+
+	/**
+	 * Arma el árbol con los cantidad nodos que siguen a primero por el
+	 * enlace Siguiente, en ese orden, en O(cantidad). Descarta lo que
+	 * hubiera antes sin tocar esos nodos.
+	 */
+	template<Nodo* Nodo::*Siguiente>
+	void armar(Nodo* primero, int cantidad){
+		raiz = NULL;
+		// Pila del borde derecho del árbol, guardada en los padres
+		Nodo* borde = NULL;
+		Nodo* nodo = primero;
+		for(int i = 0; i < cantidad; i++, nodo = nodo->*Siguiente){
+			nodo->posicion = EnlacesDePosicion<Nodo>();
+			nodo->posicion.prioridad = azar();
+			Nodo* ultimoSacado = NULL;
+			while(borde != NULL && borde->posicion.prioridad < nodo->posicion.prioridad){
+				ultimoSacado = borde;
+				borde = borde->posicion.padre;
+			}
+			nodo->posicion.izquierdo = ultimoSacado;
+			if(ultimoSacado != NULL){
+				ultimoSacado->posicion.padre = nodo;
+			}
+			nodo->posicion.padre = borde;
+			if(borde != NULL){
+				borde->posicion.derecho = nodo;
+			}
+			borde = nodo;
+		}
+		while(borde != NULL){
+			raiz = borde;
+			borde = borde->posicion.padre;
+		}
+		recalcularSubarbol(raiz);
+	}
+
+	/**
+	 * Inserta nuevo inmediatamente antes de siguiente, o al final si
+	 * siguiente es NULL.
+	 * PRE: nuevo no está en el árbol y siguiente, si no es NULL, sí.
+	 */
+	void insertarAntesDe(Nodo* nuevo, Nodo* siguiente){
+		nuevo->posicion = EnlacesDePosicion<Nodo>();
+		nuevo->posicion.prioridad = azar();
+		recalcular(nuevo);
+		if(raiz == NULL){
+			raiz = nuevo;
+			return;
+		}
+		Nodo* padre;
+		if(siguiente != NULL && siguiente->posicion.izquierdo == NULL){
+			padre = siguiente;
+			padre->posicion.izquierdo = nuevo;
+		}else{
+			padre = ultimo(siguiente == NULL ? raiz : siguiente->posicion.izquierdo);
+			padre->posicion.derecho = nuevo;
+		}
+		nuevo->posicion.padre = padre;
+		recalcularHastaLaRaiz(padre);
+		while(nuevo->posicion.padre != NULL && nuevo->posicion.padre->posicion.prioridad < nuevo->posicion.prioridad){
+			subir(nuevo);
+		}
+	}
+
+	/**
+	 * PRE: n está en el árbol.
+	 */
+	void borrar(Nodo* n){
+		// Se baja hasta ser hoja, subiendo al hijo de mayor prioridad
+		while(n->posicion.izquierdo != NULL || n->posicion.derecho != NULL){
+			Nodo* izquierdo = n->posicion.izquierdo;
+			Nodo* derecho = n->posicion.derecho;
+			subir(derecho == NULL || (izquierdo != NULL && izquierdo->posicion.prioridad > derecho->posicion.prioridad)
+				? izquierdo : derecho);
+		}
+		Nodo* padre = n->posicion.padre;
+		if(padre == NULL){
+			raiz = NULL;
+			return;
+		}
+		if(padre->posicion.izquierdo == n){
+			padre->posicion.izquierdo = NULL;
+		}else{
+			padre->posicion.derecho = NULL;
+		}
+		recalcularHastaLaRaiz(padre);
+	}
+
+	/**
+	 * Vuelve a contar los activos después de cambiar n->pausado.
+	 * PRE: n está en el árbol.
+	 */
+	void actualizarEstado(Nodo* n){
+		recalcularHastaLaRaiz(n);
+	}
+
+	/**
+	 * Cantidad de nodos antes de n en la secuencia.
+	 * PRE: n está en el árbol.
+	 */
+	int posicion(const Nodo* n) const{
+		int anteriores = cantidad(n->posicion.izquierdo);
+		for(; n->posicion.padre != NULL; n = n->posicion.padre){
+			const Nodo* padre = n->posicion.padre;
+			if(padre->posicion.derecho == n){
+				anteriores += cantidad(padre->posicion.izquierdo) + 1;
+			}
+		}
+		return anteriores;
+	}
+
+	/**
+	 * Cantidad de nodos activos antes de n en la secuencia.
+	 * PRE: n está en el árbol.
+	 */
+	int posicionEntreActivos(const Nodo* n) const{
+		int anteriores = activos(n->posicion.izquierdo);
+		for(; n->posicion.padre != NULL; n = n->posicion.padre){
+			const Nodo* padre = n->posicion.padre;
+			if(padre->posicion.derecho == n){
+				anteriores += activos(padre->posicion.izquierdo) + (padre->pausado ? 0 : 1);
+			}
+		}
+		return anteriores;
+	}
+
+	/**
+	 * PRE: 0 <= i < cantidad de nodos.
+	 */
+	Nodo* enPosicion(int i) const{
+		Nodo* n = raiz;
+		while(true){
+			assert(n != NULL);
+			int izquierda = cantidad(n->posicion.izquierdo);
+			if(i < izquierda){
+				n = n->posicion.izquierdo;
+			}else if(i == izquierda){
+				return n;
+			}else{
+				i -= izquierda + 1;
+				n = n->posicion.derecho;
+			}
+		}
+	}
+
+	/**
+	 * PRE: 0 <= i < cantidad de nodos activos.
+	 */
+	Nodo* activoEnPosicion(int i) const{
+		Nodo* n = raiz;
+		while(true){
+			assert(n != NULL);
+			int izquierda = activos(n->posicion.izquierdo);
+			if(i < izquierda){
+				n = n->posicion.izquierdo;
+			}else if(i == izquierda && !n->pausado){
+				return n;
+			}else{
+				i -= izquierda + (n->pausado ? 0 : 1);
+				n = n->posicion.derecho;
+			}
+		}
+	}
+
+  private:
+
+	static int cantidad(const Nodo* n){ return n == NULL ? 0 : n->posicion.cantidad; }
+	static int activos(const Nodo* n){ return n == NULL ? 0 : n->posicion.activos; }
+
+	static void recalcular(Nodo* n){
+		n->posicion.cantidad = 1 + cantidad(n->posicion.izquierdo) + cantidad(n->posicion.derecho);
+		n->posicion.activos = (n->pausado ? 0 : 1) + activos(n->posicion.izquierdo) + activos(n->posicion.derecho);
+	}
+
+	static void recalcularHastaLaRaiz(Nodo* n){
+		for(; n != NULL; n = n->posicion.padre){
+			recalcular(n);
+		}
+	}
+
+	static void recalcularSubarbol(Nodo* n){
+		if(n == NULL){
+			return;
+		}
+		recalcularSubarbol(n->posicion.izquierdo);
+		recalcularSubarbol(n->posicion.derecho);
+		recalcular(n);
+	}
+
+	static Nodo* ultimo(Nodo* n){
+		while(n->posicion.derecho != NULL){
+			n = n->posicion.derecho;
+		}
+		return n;
+	}
+
+	/**
+	 * Rota n por encima de su padre, sin cambiar el orden de la secuencia.
+	 * PRE: n tiene padre.
+	 */
+	void subir(Nodo* n){
+		Nodo* padre = n->posicion.padre;
+		Nodo* abuelo = padre->posicion.padre;
+		if(padre->posicion.izquierdo == n){
+			padre->posicion.izquierdo = n->posicion.derecho;
+			if(n->posicion.derecho != NULL){
+				n->posicion.derecho->posicion.padre = padre;
+			}
+			n->posicion.derecho = padre;
+		}else{
+			padre->posicion.derecho = n->posicion.izquierdo;
+			if(n->posicion.izquierdo != NULL){
+				n->posicion.izquierdo->posicion.padre = padre;
+			}
+			n->posicion.izquierdo = padre;
+		}
+		padre->posicion.padre = n;
+		n->posicion.padre = abuelo;
+		if(abuelo == NULL){
+			raiz = n;
+		}else if(abuelo->posicion.izquierdo == padre){
+			abuelo->posicion.izquierdo = n;
+		}else{
+			abuelo->posicion.derecho = n;
+		}
+		recalcular(padre);
+		recalcular(n);
+	}
+
+	uint32_t azar(){
+		semilla ^= semilla << 13;
+		semilla ^= semilla >> 17;
+		semilla ^= semilla << 5;
+		return semilla;
+	}
+
+	Nodo* raiz;
+	uint32_t semilla;
+};
+
+#endif // ARBOL_DE_POSICIONES_H_
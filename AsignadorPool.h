@@ -0,0 +1,237 @@
+#ifndef ASIGNADOR_POOL_H_
+#define ASIGNADOR_POOL_H_
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+using namespace std;
+
+/**
+ * Arena de bloques contiguos de slots de igual tamaño. Los slots libres
+ * forman una lista enlazada dentro de los propios slots, así que pedir
+ * o devolver uno cuesta O(1) y no toca el heap salvo al abrir un bloque.
+ * La memoria de los bloques se libera recién cuando se destruye la arena.
+ */
+class ArenaDeSlots {
+
+  public:
+
+	ArenaDeSlots(size_t tamSlot, size_t slotsPorBloque):
+		tamSlot(tamSlot < sizeof(Libre) ? sizeof(Libre) : tamSlot),
+		slotsPorBloque(slotsPorBloque), libres(NULL), cursor(NULL), fin(NULL){}
+
+	~ArenaDeSlots(){
+		for(size_t i = 0; i < bloques.size(); i++){
+			::operator delete(bloques[i]);
+		}
+	}
+
+	/**
+	 * Devuelve un slot, primero de la lista de libres y si no hay,
+	 * del bloque abierto.
+	 */
+	void* tomar(){
+		if(libres != NULL){
+			Libre* slot = libres;
+			libres = slot->siguiente;
+			return slot;
+		}
+		return tomarContiguos(1);
+	}
+
+	/**
+	 * Devuelve n slots consecutivos del bloque abierto, abriendo uno nuevo
+	 * si no alcanza. Nunca usa la lista de libres.
+	 */
+	void* tomarContiguos(size_t n){
+		if(cursor == NULL || (size_t)(fin - cursor) < n * tamSlot){
+			size_t slots = n > slotsPorBloque ? n : slotsPorBloque;
+			cursor = static_cast<char*>(::operator new(slots * tamSlot));
+			fin = cursor + slots * tamSlot;
+			bloques.push_back(cursor);
+		}
+		void* resultado = cursor;
+		cursor += n * tamSlot;
+		return resultado;
+	}
+
+	/**
+	 * Devuelve n slots consecutivos a la lista de libres. Se pueden
+	 * devolver de a uno slots que se pidieron juntos.
+	 */
+	void devolver(void* p, size_t n){
+		char* slot = static_cast<char*>(p);
+		for(size_t i = 0; i < n; i++, slot += tamSlot){
+			Libre* libre = reinterpret_cast<Libre*>(slot);
+			libre->siguiente = libres;
+			libres = libre;
+		}
+	}
+
+  private:
+
+	ArenaDeSlots(const ArenaDeSlots&);
+	ArenaDeSlots& operator=(const ArenaDeSlots&);
+
+	struct Libre {
+		Libre* siguiente;
+	};
+
+	size_t tamSlot;
+	size_t slotsPorBloque;
+	Libre* libres;
+	char* cursor;
+	char* fin;
+	vector<char*> bloques;
+};
+
+/**
+ * Las arenas de un pool, una por tamaño de slot: la del tipo del
+ * asignador y las de sus rebinds. Cada una se crea con el primer pedido
+ * de su tamaño.
+ */
+class ArenasDelPool {
+
+  public:
+
+	explicit ArenasDelPool(size_t slotsPorBloque): slotsPorBloque(slotsPorBloque){}
+
+	~ArenasDelPool(){
+		for(size_t i = 0; i < arenas.size(); i++){
+			delete arenas[i].arena;
+		}
+	}
+
+	/**
+	 * Devuelve la arena de slots de tamSlot bytes, creándola si no existe.
+	 */
+	ArenaDeSlots* de(size_t tamSlot){
+		for(size_t i = 0; i < arenas.size(); i++){
+			if(arenas[i].tamSlot == tamSlot){
+				return arenas[i].arena;
+			}
+		}
+		arenas.reserve(arenas.size() + 1);
+		PorTamanio nueva = {tamSlot, new ArenaDeSlots(tamSlot, slotsPorBloque)};
+		arenas.push_back(nueva);
+		return nueva.arena;
+	}
+
+  private:
+
+	ArenasDelPool(const ArenasDelPool&);
+	ArenasDelPool& operator=(const ArenasDelPool&);
+
+	struct PorTamanio {
+		size_t tamSlot;
+		ArenaDeSlots* arena;
+	};
+
+	size_t slotsPorBloque;
+	vector<PorTamanio> arenas;
+};
+
+/**
+ * Asignador con la interfaz de allocator que sirve los nodos del
+ * planificador desde una ArenaDeSlots. Las copias y los rebinds comparten
+ * el pool (ArenasDelPool), salvo el de un contenedor copiado (ver
+ * select_on_container_copy_construction): así los planificadores creados
+ * con PlanificadorRR(asignador) piden sus nodos a un mismo pool.
+ *
+ * No es seguro usar la misma arena desde varios hilos a la vez.
+ */
+template<typename T, size_t SlotsPorBloque = 256>
+class AsignadorPool {
+
+  public:
+
+	typedef T value_type;
+
+	// Los slots pedidos juntos se pueden liberar de a uno
+	static const bool liberaPorPartes = true;
+
+	template<typename U>
+	struct rebind {
+		typedef AsignadorPool<U, SlotsPorBloque> other;
+	};
+
+	AsignadorPool(): arena(NULL){}
+
+	/**
+	 * Comparte el pool de otro, que se crea ahora si otro todavía no
+	 * pidió nada.
+	 */
+	template<typename U>
+	AsignadorPool(const AsignadorPool<U, SlotsPorBloque>& otro): arenas(otro.compartidas()), arena(NULL){}
+
+	/**
+	 * Un contenedor copiado usa otra arena: la copia tiene que ser
+	 * independiente del original, y una misma arena no se puede usar
+	 * desde varios hilos.
+	 */
+	AsignadorPool<T, SlotsPorBloque> select_on_container_copy_construction() const {
+		return AsignadorPool<T, SlotsPorBloque>();
+	}
+
+	T* allocate(size_t n){
+		ArenaDeSlots* a = propia();
+		void* p = n == 1 ? a->tomar() : a->tomarContiguos(n);
+		return static_cast<T*>(p);
+	}
+
+	void deallocate(T* p, size_t n){
+		assert(arenas);
+		propia()->devolver(p, n);
+	}
+
+	bool operator==(const AsignadorPool<T, SlotsPorBloque>& otro) const {
+		return arenas == otro.arenas;
+	}
+
+	bool operator!=(const AsignadorPool<T, SlotsPorBloque>& otro) const {
+		return arenas != otro.arenas;
+	}
+
+  private:
+
+	template<typename, size_t>
+	friend class AsignadorPool;
+
+	const shared_ptr<ArenasDelPool>& compartidas() const {
+		if(!arenas){
+			arenas = make_shared<ArenasDelPool>(SlotsPorBloque);
+		}
+		return arenas;
+	}
+
+	ArenaDeSlots* propia(){
+		if(arena == NULL){
+			arena = compartidas()->de(sizeof(T));
+		}
+		return arena;
+	}
+
+	// Se crea con el primer pedido o el primer rebind, para que crear
+	// un asignador no pida memoria
+	mutable shared_ptr<ArenasDelPool> arenas;
+	// La arena de sizeof(T) dentro de arenas, una vez buscada
+	ArenaDeSlots* arena;
+};
+
+/**
+ * Informa si un asignador permite liberar de a uno los elementos que
+ * se pidieron en un mismo allocate(n).
+ */
+template<typename A, typename = void>
+struct LiberaPorPartes {
+	static const bool valor = false;
+};
+
+template<typename A>
+struct LiberaPorPartes<A, typename enable_if<A::liberaPorPartes>::type> {
+	static const bool valor = true;
+};
+
+#endif // ASIGNADOR_POOL_H_
@@ -0,0 +1,95 @@
+#ifndef BITMAP_DE_PROCESOS_H_
+#define BITMAP_DE_PROCESOS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+using namespace std;
+
+/**
+ * Operaciones sobre bitmaps de procesos guardados en palabras de 64 bits,
+ * con el bit i en la palabra i / 64. Con AVX2 (-mavx2 o -march=native)
+ * buscarCero salta de a 4 palabras llenas por comparación; sin AVX2 se
+ * compila la versión de a una palabra, que da los mismos resultados.
+ */
+
+/**
+ * Cantidad de bits en 1 de la palabra.
+ */
+inline int contarUnos(uint64_t palabra) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(palabra);
+#else
+	int cantidad = 0;
+	while(palabra != 0){
+		palabra &= palabra - 1;
+		cantidad++;
+	}
+	return cantidad;
+#endif
+}
+
+/**
+ * Posición del bit en 1 más bajo.
+ * PRE: palabra != 0.
+ */
+inline int primerUno(uint64_t palabra) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(palabra);
+#else
+	int posicion = 0;
+	while((palabra & 1) == 0){
+		palabra >>= 1;
+		posicion++;
+	}
+	return posicion;
+#endif
+}
+
+/**
+ * Cantidad de bits en 1 entre las primeras cantidad palabras.
+ */
+inline size_t contarUnos(const uint64_t* palabras, size_t cantidad) {
+	size_t total = 0;
+	for(size_t i = 0; i < cantidad; i++){
+		total += contarUnos(palabras[i]);
+	}
+	return total;
+}
+
+/**
+ * Devuelve el primer bit en 0 entre desde (incluido) y hasta (excluido),
+ * o hasta si están todos en 1.
+ */
+inline size_t buscarCero(const uint64_t* palabras, size_t desde, size_t hasta) {
+	if(desde >= hasta){
+		return hasta;
+	}
+	size_t i = desde >> 6;
+	size_t ultima = (hasta - 1) >> 6;
+	// Los bits anteriores a desde cuentan como en 1
+	uint64_t libres = ~(palabras[i] | (((uint64_t)1 << (desde & 63)) - 1));
+	while(libres == 0 && i < ultima){
+		i++;
+#ifdef __AVX2__
+		const __m256i llenas = _mm256_set1_epi64x(-1);
+		while(i + 4 <= ultima){
+			__m256i bloque = _mm256_loadu_si256((const __m256i*)(palabras + i));
+			if(_mm256_movemask_epi8(_mm256_cmpeq_epi64(bloque, llenas)) != -1){
+				break;
+			}
+			i += 4;
+		}
+#endif
+		libres = ~palabras[i];
+	}
+	if(libres == 0){
+		return hasta;
+	}
+	size_t posicion = (i << 6) + primerUno(libres);
+	return posicion < hasta ? posicion : hasta;
+}
+
+#endif // BITMAP_DE_PROCESOS_H_
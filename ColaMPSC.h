@@ -0,0 +1,118 @@
+#ifndef COLA_MPSC_H_
+#define COLA_MPSC_H_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+using namespace std;
+
+/**
+ * Cola sin locks de varios productores y un único consumidor (Vyukov).
+ * Encolar es un exchange sobre la entrada más un store, sin importar
+ * cuántos elementos haya; desencolar nunca espera a los productores: si
+ * un productor todavía no terminó de enlazar su elemento, la cola se ve
+ * vacía hasta que termine.
+ *
+ * encolar se puede llamar desde cualquier hilo; desencolar y el
+ * destructor sólo desde el hilo consumidor.
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia.
+ * No se puede asumir que el tipo T tenga operator= ni constructor por defecto.
+ */
+template<typename T>
+class ColaMPSC {
+
+  public:
+
+	ColaMPSC();
+	~ColaMPSC();
+	void encolar(const T&);
+	void encolar(T&&);
+	template<typename Funcion>
+	bool desencolar(Funcion);
+
+  private:
+
+	ColaMPSC(const ColaMPSC<T>&);
+	ColaMPSC<T>& operator=(const ColaMPSC<T>&);
+
+	struct Nodo {
+		atomic<Nodo*> siguiente;
+		// El valor está construido en todos los nodos salvo el centinela
+		alignas(T) unsigned char valor[sizeof(T)];
+		Nodo(): siguiente(NULL){}
+		T* elemento() { return reinterpret_cast<T*>(valor); }
+	};
+
+	void enlazar(Nodo*);
+
+	// Los productores enlazan después de entrada; el consumidor lee desde
+	// el siguiente de salida, que siempre es un centinela sin valor.
+	alignas(64) atomic<Nodo*> entrada;
+	alignas(64) Nodo* salida;
+};
+
+template<class T>
+ColaMPSC<T>::ColaMPSC(){
+	Nodo* centinela = new Nodo();
+	entrada.store(centinela, memory_order_relaxed);
+	salida = centinela;
+}
+
+/**
+ * PRE: Ningún productor está encolando.
+ */
+template<class T>
+ColaMPSC<T>::~ColaMPSC(){
+	Nodo* actual = salida->siguiente.load(memory_order_acquire);
+	delete salida;
+	while(actual != NULL){
+		Nodo* siguiente = actual->siguiente.load(memory_order_acquire);
+		actual->elemento()->~T();
+		delete actual;
+		actual = siguiente;
+	}
+}
+
+template<class T>
+void ColaMPSC<T>::encolar(const T& e){
+	Nodo* nuevo = new Nodo();
+	new (nuevo->valor) T(e);
+	enlazar(nuevo);
+}
+
+template<class T>
+void ColaMPSC<T>::encolar(T&& e){
+	Nodo* nuevo = new Nodo();
+	new (nuevo->valor) T(std::move(e));
+	enlazar(nuevo);
+}
+
+/**
+ * Si hay un elemento disponible, se lo pasa a f, lo saca de la cola y
+ * devuelve true. Si no, devuelve false sin esperar.
+ */
+template<class T>
+template<typename Funcion>
+bool ColaMPSC<T>::desencolar(Funcion f){
+	Nodo* siguiente = salida->siguiente.load(memory_order_acquire);
+	if(siguiente == NULL){
+		return false;
+	}
+	f(*siguiente->elemento());
+	siguiente->elemento()->~T();
+	// El siguiente pasa a ser el centinela
+	delete salida;
+	salida = siguiente;
+	return true;
+}
+
+template<class T>
+void ColaMPSC<T>::enlazar(Nodo* nuevo){
+	Nodo* anterior = entrada.exchange(nuevo, memory_order_acq_rel);
+	anterior->siguiente.store(nuevo, memory_order_release);
+}
+
+#endif // COLA_MPSC_H_
@@ -0,0 +1,183 @@
+#ifndef ESTADISTICAS_PLANIFICADOR_H_
+#define ESTADISTICAS_PLANIFICADOR_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+using namespace std;
+
+/**
+ * Operaciones del planificador que se cuentan y se miden por separado.
+ * Las versiones masivas (agregarProcesos, pausarSi, ...) cuentan como
+ * una llamada de la operación correspondiente.
+ */
+enum OperacionDelPlanificador {
+	OP_AGREGAR,
+	OP_ELIMINAR,
+	OP_PAUSAR,
+	OP_REANUDAR,
+	OP_EJECUTAR,
+	OP_BUSCAR,
+	OP_COPIAR,
+	OP_SEPARAR,
+	OP_COMPARAR,
+	OP_MOSTRAR,
+	OP_VACIAR,
+	CANTIDAD_DE_OPERACIONES
+};
+
+inline const char* nombreDeOperacion(OperacionDelPlanificador op) {
+	static const char* const nombres[CANTIDAD_DE_OPERACIONES] = {
+		"agregar", "eliminar", "pausar", "reanudar", "ejecutar", "buscar",
+		"copiar", "separar", "comparar", "mostrar", "vaciar"
+	};
+	return nombres[op];
+}
+
+/**
+ * Copia de las estadísticas en un momento dado. latencias[op][i] cuenta
+ * las llamadas que tardaron entre 2^(i-1) y 2^i - 1 nanosegundos (la
+ * cubeta 0 es la de menos de un nanosegundo).
+ */
+struct InstantaneaDeEstadisticas {
+	static const int CUBETAS = 64;
+	uint64_t llamadas[CANTIDAD_DE_OPERACIONES];
+	uint64_t saltos;
+	uint64_t asignaciones;
+	uint64_t liberaciones;
+	uint64_t latencias[CANTIDAD_DE_OPERACIONES][CUBETAS];
+
+	InstantaneaDeEstadisticas() { memset(this, 0, sizeof(*this)); }
+};
+
+/**
+ * Política por defecto: no cuenta nada. Es una clase vacía y todos sus
+ * métodos son vacíos e inline, así que el planificador no ocupa ni
+ * ejecuta nada de más.
+ */
+struct SinEstadisticas {
+	static const bool habilitadas = false;
+	void contarLlamada(OperacionDelPlanificador) const {}
+	void contarSaltos(long) const {}
+	void contarAsignaciones(long) const {}
+	void contarLiberaciones(long) const {}
+	void registrarLatencia(OperacionDelPlanificador, uint64_t) const {}
+	InstantaneaDeEstadisticas estadisticas() const { return InstantaneaDeEstadisticas(); }
+};
+
+/**
+ * Cuenta llamadas por operación, saltos entre nodos, asignaciones y
+ * liberaciones de nodos, y arma un histograma logarítmico de latencias
+ * por operación. Los contadores son atómicos relajados, así que se
+ * pueden leer con estadisticas() desde otro hilo mientras el
+ * planificador trabaja. Cada copia del planificador empieza en cero.
+ */
+class EstadisticasAtomicas {
+
+  public:
+
+	static const bool habilitadas = true;
+
+	EstadisticasAtomicas() { poner0(); }
+	EstadisticasAtomicas(const EstadisticasAtomicas&) { poner0(); }
+	EstadisticasAtomicas& operator=(const EstadisticasAtomicas&) { return *this; }
+
+	void contarLlamada(OperacionDelPlanificador op) const {
+		llamadas[op].fetch_add(1, memory_order_relaxed);
+	}
+	void contarSaltos(long n) const {
+		saltos.fetch_add(n, memory_order_relaxed);
+	}
+	void contarAsignaciones(long n) const {
+		asignaciones.fetch_add(n, memory_order_relaxed);
+	}
+	void contarLiberaciones(long n) const {
+		liberaciones.fetch_add(n, memory_order_relaxed);
+	}
+	void registrarLatencia(OperacionDelPlanificador op, uint64_t nanosegundos) const {
+		int cubeta = nanosegundos == 0 ? 0 : 64 - __builtin_clzll(nanosegundos);
+		if(cubeta >= InstantaneaDeEstadisticas::CUBETAS){
+			cubeta = InstantaneaDeEstadisticas::CUBETAS - 1;
+		}
+		latencias[op][cubeta].fetch_add(1, memory_order_relaxed);
+	}
+
+	/**
+	 * Lee cada contador por separado: es barato, pero con el planificador
+	 * trabajando los totales pueden no ser consistentes entre sí.
+	 */
+	InstantaneaDeEstadisticas estadisticas() const {
+		InstantaneaDeEstadisticas foto;
+		for(int op = 0; op < CANTIDAD_DE_OPERACIONES; op++){
+			foto.llamadas[op] = llamadas[op].load(memory_order_relaxed);
+			for(int i = 0; i < InstantaneaDeEstadisticas::CUBETAS; i++){
+				foto.latencias[op][i] = latencias[op][i].load(memory_order_relaxed);
+			}
+		}
+		foto.saltos = saltos.load(memory_order_relaxed);
+		foto.asignaciones = asignaciones.load(memory_order_relaxed);
+		foto.liberaciones = liberaciones.load(memory_order_relaxed);
+		return foto;
+	}
+
+  private:
+
+	void poner0() {
+		for(int op = 0; op < CANTIDAD_DE_OPERACIONES; op++){
+			llamadas[op].store(0, memory_order_relaxed);
+			for(int i = 0; i < InstantaneaDeEstadisticas::CUBETAS; i++){
+				latencias[op][i].store(0, memory_order_relaxed);
+			}
+		}
+		saltos.store(0, memory_order_relaxed);
+		asignaciones.store(0, memory_order_relaxed);
+		liberaciones.store(0, memory_order_relaxed);
+	}
+
+	mutable atomic<uint64_t> llamadas[CANTIDAD_DE_OPERACIONES];
+	mutable atomic<uint64_t> saltos;
+	mutable atomic<uint64_t> asignaciones;
+	mutable atomic<uint64_t> liberaciones;
+	mutable atomic<uint64_t> latencias[CANTIDAD_DE_OPERACIONES][InstantaneaDeEstadisticas::CUBETAS];
+};
+
+/**
+ * Cuenta una llamada y mide cuánto tarda, desde que se construye hasta
+ * que se destruye. Sin estadísticas no lee el reloj.
+ */
+template<typename Estadisticas, bool = Estadisticas::habilitadas>
+class MedicionDeOperacion {
+
+  public:
+
+	MedicionDeOperacion(const Estadisticas&, OperacionDelPlanificador) {}
+};
+
+template<typename Estadisticas>
+class MedicionDeOperacion<Estadisticas, true> {
+
+  public:
+
+	MedicionDeOperacion(const Estadisticas& e, OperacionDelPlanificador op):
+		estadisticas(e), operacion(op), inicio(chrono::steady_clock::now()) {
+		estadisticas.contarLlamada(op);
+	}
+
+	~MedicionDeOperacion() {
+		chrono::steady_clock::duration duracion = chrono::steady_clock::now() - inicio;
+		estadisticas.registrarLatencia(operacion,
+			(uint64_t)chrono::duration_cast<chrono::nanoseconds>(duracion).count());
+	}
+
+  private:
+
+	MedicionDeOperacion(const MedicionDeOperacion&);
+	MedicionDeOperacion& operator=(const MedicionDeOperacion&);
+
+	const Estadisticas& estadisticas;
+	OperacionDelPlanificador operacion;
+	chrono::steady_clock::time_point inicio;
+};
+
+#endif // ESTADISTICAS_PLANIFICADOR_H_
@@ -0,0 +1,356 @@
+#ifndef EVENTOS_PLANIFICADOR_H_
+#define EVENTOS_PLANIFICADOR_H_
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <stdint.h>
+#include <type_traits>
+#include "PlanificadorRR.h"
+using namespace std;
+
+enum TipoDeEvento {
+	EVENTO_AGREGAR = 1,
+	EVENTO_ELIMINAR,
+	EVENTO_PAUSAR,
+	EVENTO_REANUDAR,
+	// Cambió el proceso que devuelve procesoEjecutado; pid es el nuevo
+	EVENTO_CAMBIO_DE_PROCESO,
+	EVENTO_DETENER,
+	EVENTO_REANUDAR_PLANIFICADOR
+};
+
+/**
+ * Un evento del planificador. instante está en nanosegundos de
+ * steady_clock; los eventos de una misma operación tienen el mismo.
+ */
+template<typename T>
+struct EventoDelPlanificador {
+	uint64_t instante;
+	T pid;
+	uint8_t tipo;
+};
+
+/**
+ * Qué hace el productor cuando el buffer está lleno: pisar el evento más
+ * viejo todavía sin leer, o descartar el nuevo.
+ */
+enum ModoDeDesborde {
+	PISAR_MAS_VIEJOS,
+	DESCARTAR_NUEVOS
+};
+
+/**
+ * Buffer circular sin locks de un productor y un consumidor, de eventos de
+ * tamaño fijo. publicar nunca espera ni pide memoria: todos los lugares se
+ * reservan al construirlo. Cada lugar es un seqlock (su secuencia es impar
+ * mientras se escribe), así que pisando a los más viejos el consumidor
+ * detecta los eventos que le cambiaron mientras los leía y los cuenta como
+ * perdidos en lugar de devolverlos a medias.
+ *
+ * publicar se llama sólo desde el hilo productor; consumir, sólo desde el
+ * hilo consumidor.
+ *
+ * PRE: T es trivialmente copiable.
+ */
+template<typename T>
+class BufferDeEventos {
+
+	static_assert(is_trivially_copyable<T>::value, "los eventos se copian como bytes");
+
+  public:
+
+	typedef EventoDelPlanificador<T> Evento;
+
+	BufferDeEventos(size_t, ModoDeDesborde);
+	~BufferDeEventos();
+	bool publicar(const Evento&);
+	size_t consumir(Evento*, size_t);
+	uint64_t perdidos() const;
+	size_t capacidad() const;
+
+  private:
+
+	BufferDeEventos(const BufferDeEventos<T>&);
+	BufferDeEventos<T>& operator=(const BufferDeEventos<T>&);
+
+	static const size_t PALABRAS = (sizeof(Evento) + 7) / 8;
+
+	/**
+	 * El evento n se guarda en el lugar n % capacidad. Su secuencia es
+	 * 2n + 1 mientras se escribe y 2n + 2 una vez escrito. El evento va en
+	 * palabras atómicas para que leer uno que se está pisando no sea una
+	 * carrera de datos.
+	 */
+	struct Lugar {
+		atomic<uint64_t> secuencia;
+		atomic<uint64_t> palabras[PALABRAS];
+	};
+
+	uint64_t saltearPerdidos(uint64_t);
+
+	Lugar* lugares;
+	size_t mascara;
+	ModoDeDesborde modo;
+	// Cuántos eventos publicó el productor y cuántos consumió o perdió el
+	// consumidor; cada uno escribe sólo el suyo
+	alignas(64) atomic<uint64_t> escritos;
+	alignas(64) atomic<uint64_t> leidos;
+	// Lo aumentan los dos hilos
+	atomic<uint64_t> cantidadPerdidos;
+};
+
+/**
+ * PRE: capacidad es una potencia de 2.
+ */
+template<class T>
+BufferDeEventos<T>::BufferDeEventos(size_t capacidad, ModoDeDesborde m){
+	assert(capacidad > 0 && (capacidad & (capacidad - 1)) == 0);
+	lugares = new Lugar[capacidad];
+	for(size_t i = 0; i < capacidad; i++){
+		lugares[i].secuencia.store(0, memory_order_relaxed);
+	}
+	mascara = capacidad - 1;
+	modo = m;
+	escritos.store(0, memory_order_relaxed);
+	leidos.store(0, memory_order_relaxed);
+	cantidadPerdidos.store(0, memory_order_relaxed);
+}
+
+/**
+ * PRE: Ningún hilo está publicando ni consumiendo.
+ */
+template<class T>
+BufferDeEventos<T>::~BufferDeEventos(){
+	delete[] lugares;
+}
+
+/**
+ * Agrega un evento. Devuelve false si el buffer estaba lleno y, en modo
+ * DESCARTAR_NUEVOS, el evento se descartó.
+ */
+template<class T>
+bool BufferDeEventos<T>::publicar(const Evento& e){
+	uint64_t n = escritos.load(memory_order_relaxed);
+	if(modo == DESCARTAR_NUEVOS && n - leidos.load(memory_order_acquire) > mascara){
+		cantidadPerdidos.fetch_add(1, memory_order_relaxed);
+		return false;
+	}
+	uint64_t copia[PALABRAS] = {};
+	memcpy(copia, &e, sizeof(Evento));
+	Lugar& lugar = lugares[n & mascara];
+	lugar.secuencia.store(2 * n + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	for(size_t i = 0; i < PALABRAS; i++){
+		lugar.palabras[i].store(copia[i], memory_order_relaxed);
+	}
+	lugar.secuencia.store(2 * n + 2, memory_order_release);
+	escritos.store(n + 1, memory_order_release);
+	return true;
+}
+
+/**
+ * Copia en destino hasta maximo eventos, los más viejos primero, y
+ * devuelve cuántos copió. No espera: si no hay eventos devuelve 0.
+ */
+template<class T>
+size_t BufferDeEventos<T>::consumir(Evento* destino, size_t maximo){
+	uint64_t leido = saltearPerdidos(leidos.load(memory_order_relaxed));
+	uint64_t escrito = escritos.load(memory_order_acquire);
+	size_t copiados = 0;
+	while(copiados < maximo && leido < escrito){
+		Lugar& lugar = lugares[leido & mascara];
+		uint64_t secuencia = lugar.secuencia.load(memory_order_acquire);
+		uint64_t copia[PALABRAS];
+		for(size_t i = 0; i < PALABRAS; i++){
+			copia[i] = lugar.palabras[i].load(memory_order_relaxed);
+		}
+		atomic_thread_fence(memory_order_acquire);
+		if(secuencia != 2 * leido + 2 || lugar.secuencia.load(memory_order_relaxed) != secuencia){
+			// Lo pisó el productor, antes o mientras se leía
+			leido = saltearPerdidos(leido + 1);
+			cantidadPerdidos.fetch_add(1, memory_order_relaxed);
+			continue;
+		}
+		memcpy(&destino[copiados], copia, sizeof(Evento));
+		copiados++;
+		leido++;
+	}
+	leidos.store(leido, memory_order_release);
+	return copiados;
+}
+
+/**
+ * Eventos que el consumidor no llegó a leer: los pisados o, en modo
+ * DESCARTAR_NUEVOS, los descartados.
+ */
+template<class T>
+uint64_t BufferDeEventos<T>::perdidos() const{
+	return cantidadPerdidos.load(memory_order_relaxed);
+}
+
+template<class T>
+size_t BufferDeEventos<T>::capacidad() const{
+	return mascara + 1;
+}
+
+/**
+ * Si desde leido ya se escribieron más eventos de los que entran, los
+ * más viejos ya fueron pisados: los cuenta como perdidos y devuelve el
+ * primero que todavía puede estar.
+ */
+template<class T>
+uint64_t BufferDeEventos<T>::saltearPerdidos(uint64_t leido){
+	uint64_t escrito = escritos.load(memory_order_acquire);
+	if(escrito - leido <= mascara + 1){
+		return leido;
+	}
+	uint64_t primero = escrito - (mascara + 1);
+	cantidadPerdidos.fetch_add(primero - leido, memory_order_relaxed);
+	return primero;
+}
+
+/**
+ * Planificador que publica en un BufferDeEventos cada operación que
+ * modifica sus procesos y cada cambio del proceso en ejecución, para que
+ * otro hilo los lea. Sin buffer se comporta igual que Planificador y no
+ * publica nada. Con el buffer lleno nunca espera (ver ModoDeDesborde).
+ *
+ * Los pids tienen que ser enteros. Planificador es cualquier planificador
+ * con la interfaz de PlanificadorRR.
+ */
+template<typename T, typename Planificador = PlanificadorRR<T> >
+class PlanificadorConEventos {
+
+	static_assert(is_integral<T>::value, "los eventos guardan pids enteros");
+
+  public:
+
+	explicit PlanificadorConEventos(BufferDeEventos<T>* eventos = NULL);
+	void agregarProceso(const T&);
+	void eliminarProceso(const T&);
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+	void ejecutarSiguienteProceso();
+	void detener();
+	void reanudar();
+	const Planificador& planificador() const;
+
+  private:
+
+	PlanificadorConEventos(const PlanificadorConEventos<T, Planificador>&);
+	PlanificadorConEventos<T, Planificador>& operator=(const PlanificadorConEventos<T, Planificador>&);
+
+	template<typename Operacion>
+	void publicarCon(TipoDeEvento, const T&, Operacion);
+	void publicar(TipoDeEvento, const T&, uint64_t);
+	static uint64_t ahora();
+
+	Planificador planificadorInterno;
+	BufferDeEventos<T>* eventos;
+};
+
+template<class T, class Planificador>
+PlanificadorConEventos<T, Planificador>::PlanificadorConEventos(BufferDeEventos<T>* e){
+	eventos = e;
+}
+
+template<class T, class Planificador>
+void PlanificadorConEventos<T, Planificador>::agregarProceso(const T& pid){
+	publicarCon(EVENTO_AGREGAR, pid, [this, &pid]() { planificadorInterno.agregarProceso(pid); });
+}
+
+template<class T, class Planificador>
+void PlanificadorConEventos<T, Planificador>::eliminarProceso(const T& pid){
+	publicarCon(EVENTO_ELIMINAR, pid, [this, &pid]() { planificadorInterno.eliminarProceso(pid); });
+}
+
+template<class T, class Planificador>
+void PlanificadorConEventos<T, Planificador>::pausarProceso(const T& pid){
+	publicarCon(EVENTO_PAUSAR, pid, [this, &pid]() { planificadorInterno.pausarProceso(pid); });
+}
+
+template<class T, class Planificador>
+void PlanificadorConEventos<T, Planificador>::reanudarProceso(const T& pid){
+	publicarCon(EVENTO_REANUDAR, pid, [this, &pid]() { planificadorInterno.reanudarProceso(pid); });
+}
+
+/**
+ * Sólo publica el cambio de proceso (si hay más de un activo, siempre).
+ */
+template<class T, class Planificador>
+void PlanificadorConEventos<T, Planificador>::ejecutarSiguienteProceso(){
+	if(eventos == NULL){
+		planificadorInterno.ejecutarSiguienteProceso();
+		return;
+	}
+	T anterior(planificadorInterno.procesoEjecutado());
+	planificadorInterno.ejecutarSiguienteProceso();
+	if(!(planificadorInterno.procesoEjecutado() == anterior)){
+		publicar(EVENTO_CAMBIO_DE_PROCESO, planificadorInterno.procesoEjecutado(), ahora());
+	}
+}
+
+/**
+ * El pid de los eventos de detener y reanudar es el proceso en ejecución,
+ * o 0 si no hay procesos.
+ */
+template<class T, class Planificador>
+void PlanificadorConEventos<T, Planificador>::detener(){
+	planificadorInterno.detener();
+	if(eventos != NULL){
+		publicar(EVENTO_DETENER, planificadorInterno.hayProcesos() ? planificadorInterno.procesoEjecutado() : T(), ahora());
+	}
+}
+
+template<class T, class Planificador>
+void PlanificadorConEventos<T, Planificador>::reanudar(){
+	planificadorInterno.reanudar();
+	if(eventos != NULL){
+		publicar(EVENTO_REANUDAR_PLANIFICADOR, planificadorInterno.hayProcesos() ? planificadorInterno.procesoEjecutado() : T(), ahora());
+	}
+}
+
+template<class T, class Planificador>
+const Planificador& PlanificadorConEventos<T, Planificador>::planificador() const{
+	return planificadorInterno;
+}
+
+/**
+ * Aplica la operación y publica su evento y, si cambió el proceso en
+ * ejecución, el evento del cambio, los dos con el mismo instante.
+ */
+template<class T, class Planificador>
+template<typename Operacion>
+void PlanificadorConEventos<T, Planificador>::publicarCon(TipoDeEvento tipo, const T& pid, Operacion operacion){
+	if(eventos == NULL){
+		operacion();
+		return;
+	}
+	bool habia = planificadorInterno.hayProcesos();
+	// pid y el actual se copian: pid puede ser una referencia al nodo que
+	// la operación elimina
+	T copia(pid);
+	T anterior(habia ? planificadorInterno.procesoEjecutado() : pid);
+	operacion();
+	uint64_t instante = ahora();
+	publicar(tipo, copia, instante);
+	if(planificadorInterno.hayProcesos() && (!habia || !(planificadorInterno.procesoEjecutado() == anterior))){
+		publicar(EVENTO_CAMBIO_DE_PROCESO, planificadorInterno.procesoEjecutado(), instante);
+	}
+}
+
+template<class T, class Planificador>
+void PlanificadorConEventos<T, Planificador>::publicar(TipoDeEvento tipo, const T& pid, uint64_t instante){
+	typename BufferDeEventos<T>::Evento evento = {instante, pid, (uint8_t)tipo};
+	eventos->publicar(evento);
+}
+
+template<class T, class Planificador>
+uint64_t PlanificadorConEventos<T, Planificador>::ahora(){
+	return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+		chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // EVENTOS_PLANIFICADOR_H_
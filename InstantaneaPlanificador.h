@@ -0,0 +1,262 @@
+#ifndef INSTANTANEA_PLANIFICADOR_H_
+#define INSTANTANEA_PLANIFICADOR_H_
+
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * PlanificadorRR::guardar y PlanificadorRR::cargar, con lo que necesitan.
+ * Usan mmap y el resto de la API POSIX, así que están aparte: sólo los
+ * tiene quien incluye este archivo.
+ */
+
+/**
+ * Formato de los archivos de guardar/cargar: esta cabecera, los bits de
+ * pausado (uno por proceso, en bloques de 8 bytes) y los pids tal como
+ * los escribe SerializadorDeProcesos<T>, en orden de ejecución a partir
+ * del actual. Los números están en el orden de bytes de la máquina: un
+ * archivo se carga en el mismo tipo de máquina que lo guardó.
+ */
+struct CabeceraDeInstantanea {
+	char marca[4];
+	uint8_t version;
+	uint8_t detenido;
+	uint8_t reservado[2];
+	uint64_t cantidad;
+};
+
+static const char MARCA_DE_INSTANTANEA[4] = {'P', 'R', 'R', 'S'};
+static const uint8_t VERSION_DE_INSTANTANEA = 1;
+
+inline size_t bytesDePausados(uint64_t cantidad) {
+	return (size_t)((cantidad + 63) / 64) * 8;
+}
+
+/**
+ * Cómo se guardan los pids de tipo T. Para guardar planificadores de un
+ * tipo propio hay que especializarlo con:
+ *
+ *   static void escribir(string& salida, const T& pid);
+ *   template<typename Funcion>
+ *   static const char* leer(const char* desde, const char* hasta, Funcion f);
+ *
+ * leer llama a f con el pid que empieza en desde y devuelve dónde
+ * termina, o NULL si no entra entero antes de hasta.
+ *
+ * Los tipos trivialmente copiables se guardan tal cual están en memoria.
+ */
+template<typename T, typename = void>
+struct SerializadorDeProcesos {
+	static const bool disponible = false;
+};
+
+template<typename T>
+struct SerializadorDeProcesos<T, typename enable_if<is_trivially_copyable<T>::value>::type> {
+	static const bool disponible = true;
+
+	static void escribir(string& salida, const T& pid) {
+		salida.append((const char*)&pid, sizeof(T));
+	}
+
+	template<typename Funcion>
+	static const char* leer(const char* desde, const char* hasta, Funcion funcion) {
+		if((size_t)(hasta - desde) < sizeof(T)){
+			return NULL;
+		}
+		// En el archivo puede no estar alineado
+		alignas(T) char copia[sizeof(T)];
+		memcpy(copia, desde, sizeof(T));
+		funcion(*reinterpret_cast<const T*>(copia));
+		return desde + sizeof(T);
+	}
+};
+
+/**
+ * Los strings se guardan con su largo (4 bytes) delante.
+ */
+template<>
+struct SerializadorDeProcesos<string> {
+	static const bool disponible = true;
+
+	static void escribir(string& salida, const string& pid) {
+		uint32_t largo = (uint32_t)pid.size();
+		salida.append((const char*)&largo, sizeof(largo));
+		salida.append(pid);
+	}
+
+	template<typename Funcion>
+	static const char* leer(const char* desde, const char* hasta, Funcion funcion) {
+		uint32_t largo;
+		if((size_t)(hasta - desde) < sizeof(largo)){
+			return NULL;
+		}
+		memcpy(&largo, desde, sizeof(largo));
+		desde += sizeof(largo);
+		if((size_t)(hasta - desde) < largo){
+			return NULL;
+		}
+		funcion(string(desde, largo));
+		return desde + largo;
+	}
+};
+
+/**
+ * Un archivo mapeado en memoria para leerlo entero, de una vez. Se
+ * desmapea al destruirse.
+ */
+class ArchivoMapeado {
+
+  public:
+
+	explicit ArchivoMapeado(const char* ruta): mapa(NULL), tamanio(0) {
+		int descriptor = open(ruta, O_RDONLY);
+		if(descriptor < 0){
+			return;
+		}
+		struct stat estado;
+		if(fstat(descriptor, &estado) == 0 && estado.st_size > 0){
+			void* m = mmap(NULL, estado.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if(m != MAP_FAILED){
+				mapa = (const char*)m;
+				tamanio = estado.st_size;
+				madvise(m, tamanio, MADV_SEQUENTIAL);
+			}
+		}
+		close(descriptor);
+	}
+
+	~ArchivoMapeado() {
+		if(mapa != NULL){
+			munmap((void*)mapa, tamanio);
+		}
+	}
+
+	bool abierto() const { return mapa != NULL; }
+	const char* datos() const { return mapa; }
+	size_t largo() const { return tamanio; }
+
+  private:
+
+	ArchivoMapeado(const ArchivoMapeado&);
+	ArchivoMapeado& operator=(const ArchivoMapeado&);
+
+	const char* mapa;
+	size_t tamanio;
+};
+
+/**
+ * Guarda en el archivo el orden de ejecución, qué procesos están
+ * pausados, cuál es el actual y si está detenido (ver
+ * CabeceraDeInstantanea). Arma el archivo entero en memoria y lo escribe
+ * de una vez. Devuelve false si no lo pudo escribir.
+ * PRE: SerializadorDeProcesos<T> está disponible.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+bool PlanificadorRR<T, Hash, Asignador, Estadisticas>::guardar(const char* ruta) const{
+	static_assert(SerializadorDeProcesos<T>::disponible,
+		"guardar necesita pids trivialmente copiables o una especialización de SerializadorDeProcesos");
+	CabeceraDeInstantanea cabecera;
+	memset(&cabecera, 0, sizeof(cabecera));
+	memcpy(cabecera.marca, MARCA_DE_INSTANTANEA, sizeof(cabecera.marca));
+	cabecera.version = VERSION_DE_INSTANTANEA;
+	cabecera.detenido = planificadorDetenido;
+	cabecera.cantidad = rep->cantidadProcesos;
+	size_t inicioPausados = sizeof(cabecera);
+	string contenido((const char*)&cabecera, sizeof(cabecera));
+	contenido.append(bytesDePausados(cabecera.cantidad), '\0');
+	contadores().contarSaltos(rep->cantidadProcesos);
+	const Nodo* actual = procesoActual;
+	for(int i = 0; i < rep->cantidadProcesos; i++){
+		if(actual->pausado){
+			contenido[inicioPausados + i / 8] |= (char)(1 << (i % 8));
+		}
+		SerializadorDeProcesos<T>::escribir(contenido, actual->pid);
+		actual = actual->siguiente;
+	}
+	ofstream archivo(ruta, ios::binary | ios::trunc);
+	archivo.write(contenido.data(), contenido.size());
+	archivo.close();
+	return !archivo.fail();
+}
+
+/**
+ * Reemplaza el contenido del planificador por el guardado en el archivo.
+ * Mapea el archivo y arma el anillo en una sola pasada, sin buscar cada
+ * proceso en el anillo. Si el archivo no existe o no es válido, devuelve
+ * false y deja el planificador como estaba.
+ * PRE: SerializadorDeProcesos<T> está disponible.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+bool PlanificadorRR<T, Hash, Asignador, Estadisticas>::cargar(const char* ruta){
+	static_assert(SerializadorDeProcesos<T>::disponible,
+		"cargar necesita pids trivialmente copiables o una especialización de SerializadorDeProcesos");
+	ArchivoMapeado archivo(ruta);
+	CabeceraDeInstantanea cabecera;
+	if(!archivo.abierto() || archivo.largo() < sizeof(cabecera)){
+		return false;
+	}
+	memcpy(&cabecera, archivo.datos(), sizeof(cabecera));
+	size_t disponibles = archivo.largo() - sizeof(cabecera);
+	if(memcmp(cabecera.marca, MARCA_DE_INSTANTANEA, sizeof(cabecera.marca)) != 0
+			|| cabecera.version != VERSION_DE_INSTANTANEA
+			|| cabecera.cantidad > (uint64_t)disponibles || cabecera.cantidad > 0x7FFFFFFF
+			|| bytesDePausados(cabecera.cantidad) > disponibles){
+		return false;
+	}
+	const unsigned char* pausados = (const unsigned char*)archivo.datos() + sizeof(cabecera);
+	const char* actual = archivo.datos() + sizeof(cabecera) + bytesDePausados(cabecera.cantidad);
+	const char* fin = archivo.datos() + archivo.largo();
+	int cantidad = (int)cabecera.cantidad;
+
+	// Se arma aparte para no tocar este planificador si el archivo está
+	// mal, pero con su asignador (ver asignadorPropio)
+	PlanificadorRR<T, Hash, Asignador, Estadisticas> cargado;
+	cargado.soltar(cargado.rep, cargado.procesoActual);
+	cargado.rep = new Representacion(asignadorPropio());
+	cargado.rep->indice.reservar(cantidad);
+	bool valido = true;
+	for(int i = 0; i < cantidad && valido; i++){
+		actual = SerializadorDeProcesos<T>::leer(actual, fin, [&cargado, &valido](const T& pid){
+			// Sin índice no se controlan los repetidos: sería cuadrático
+			if(cargado.rep->indice.habilitado && cargado.dameProceso(pid) != NULL){
+				valido = false;
+				return;
+			}
+			cargado.enlazarNuevo(cargado.crearNodo(pid));
+		});
+		valido = valido && actual != NULL;
+	}
+	if(!valido){
+		return false;
+	}
+	// Cada agregado quedó detrás de los anteriores, así que el anillo ya
+	// está en el orden guardado. El actual se pausa último: sólo está
+	// pausado si lo están todos.
+	if(cantidad > 0){
+		Nodo* nodo = cargado.procesoActual->siguiente;
+		for(int i = 1; i < cantidad; i++){
+			Nodo* siguiente = nodo->siguiente;
+			if(pausados[i / 8] & (1 << (i % 8))){
+				cargado.pausarNodo(nodo);
+			}
+			nodo = siguiente;
+		}
+		if(pausados[0] & 1){
+			cargado.pausarNodo(cargado.procesoActual);
+		}
+	}
+	cargado.planificadorDetenido = cabecera.detenido != 0;
+	*this = std::move(cargado);
+	return true;
+}
+
+#endif // INSTANTANEA_PLANIFICADOR_H_
@@ -0,0 +1,166 @@
+#ifndef PLANIFICADOR_CONCURRENTE_H_
+#define PLANIFICADOR_CONCURRENTE_H_
+
+#include "PlanificadorRR.h"
+#include "ColaMPSC.h"
+using namespace std;
+
+/**
+ * Frente concurrente de un planificador: cualquier hilo puede pedir que
+ * se agregue, elimine, pause o reanude un proceso, y los pedidos se
+ * guardan en una ColaMPSC sin tomar locks. El hilo del planificador los
+ * aplica en tandas, en orden de llegada, cada vez que despacha.
+ *
+ * Como los pedidos se aplican más tarde, los que ya no tienen sentido al
+ * aplicarse (agregar un proceso planificado, eliminar uno que no está,
+ * pausar uno pausado, reanudar uno activo) se descartan en lugar de
+ * violar las precondiciones del planificador.
+ *
+ * Los pedir* se pueden llamar desde cualquier hilo. El resto de los
+ * métodos, y todo el acceso a planificador(), sólo desde el hilo del
+ * planificador.
+ *
+ * Planificador es cualquier planificador con la interfaz de PlanificadorRR.
+ */
+template<typename T, typename Planificador = PlanificadorRR<T> >
+class PlanificadorConcurrente {
+
+  public:
+
+	static const int TANDA_POR_DEFECTO = 64;
+
+	PlanificadorConcurrente();
+	void pedirAgregar(const T&);
+	void pedirEliminar(const T&);
+	void pedirPausar(const T&);
+	void pedirReanudar(const T&);
+	int aplicarPedidos(int maximo = -1);
+	void ejecutarSiguienteProceso(int tanda = TANDA_POR_DEFECTO);
+	int pedidosDescartados() const;
+	Planificador& planificador();
+	const Planificador& planificador() const;
+
+  private:
+
+	PlanificadorConcurrente(const PlanificadorConcurrente<T, Planificador>&);
+	PlanificadorConcurrente<T, Planificador>& operator=(const PlanificadorConcurrente<T, Planificador>&);
+
+	enum TipoDePedido { AGREGAR, ELIMINAR, PAUSAR, REANUDAR };
+
+	struct Pedido {
+		TipoDePedido tipo;
+		T pid;
+		Pedido(TipoDePedido tipo, const T& pid): tipo(tipo), pid(pid){}
+	};
+
+	void aplicar(const Pedido&);
+
+	Planificador planificadorInterno;
+	ColaMPSC<Pedido> pedidos;
+	int descartados;
+};
+
+template<class T, class Planificador>
+PlanificadorConcurrente<T, Planificador>::PlanificadorConcurrente(){
+	descartados = 0;
+}
+
+template<class T, class Planificador>
+void PlanificadorConcurrente<T, Planificador>::pedirAgregar(const T& p){
+	pedidos.encolar(Pedido(AGREGAR, p));
+}
+
+template<class T, class Planificador>
+void PlanificadorConcurrente<T, Planificador>::pedirEliminar(const T& p){
+	pedidos.encolar(Pedido(ELIMINAR, p));
+}
+
+template<class T, class Planificador>
+void PlanificadorConcurrente<T, Planificador>::pedirPausar(const T& p){
+	pedidos.encolar(Pedido(PAUSAR, p));
+}
+
+template<class T, class Planificador>
+void PlanificadorConcurrente<T, Planificador>::pedirReanudar(const T& p){
+	pedidos.encolar(Pedido(REANUDAR, p));
+}
+
+/**
+ * Aplica hasta maximo pedidos (todos los disponibles si es negativo) y
+ * devuelve cuántos sacó de la cola, descartados incluidos. No espera a
+ * los productores que todavía están encolando.
+ */
+template<class T, class Planificador>
+int PlanificadorConcurrente<T, Planificador>::aplicarPedidos(int maximo){
+	int aplicados = 0;
+	while(aplicados != maximo){
+		bool hubo = pedidos.desencolar([this](const Pedido& pedido){ aplicar(pedido); });
+		if(!hubo){
+			break;
+		}
+		aplicados++;
+	}
+	return aplicados;
+}
+
+/**
+ * Aplica una tanda de pedidos pendientes y, si hay procesos activos,
+ * procede a ejecutar el siguiente.
+ */
+template<class T, class Planificador>
+void PlanificadorConcurrente<T, Planificador>::ejecutarSiguienteProceso(int tanda){
+	aplicarPedidos(tanda);
+	if(planificadorInterno.hayProcesosActivos()){
+		planificadorInterno.ejecutarSiguienteProceso();
+	}
+}
+
+template<class T, class Planificador>
+int PlanificadorConcurrente<T, Planificador>::pedidosDescartados() const{
+	return descartados;
+}
+
+template<class T, class Planificador>
+Planificador& PlanificadorConcurrente<T, Planificador>::planificador(){
+	return planificadorInterno;
+}
+
+template<class T, class Planificador>
+const Planificador& PlanificadorConcurrente<T, Planificador>::planificador() const{
+	return planificadorInterno;
+}
+
+//Metodos auxiliares
+template<class T, class Planificador>
+void PlanificadorConcurrente<T, Planificador>::aplicar(const Pedido& pedido){
+	bool planificado = planificadorInterno.esPlanificado(pedido.pid);
+	switch(pedido.tipo){
+	case AGREGAR:
+		if(!planificado){
+			planificadorInterno.agregarProceso(pedido.pid);
+			return;
+		}
+		break;
+	case ELIMINAR:
+		if(planificado){
+			planificadorInterno.eliminarProceso(pedido.pid);
+			return;
+		}
+		break;
+	case PAUSAR:
+		if(planificado && planificadorInterno.estaActivo(pedido.pid)){
+			planificadorInterno.pausarProceso(pedido.pid);
+			return;
+		}
+		break;
+	case REANUDAR:
+		if(planificado && !planificadorInterno.estaActivo(pedido.pid)){
+			planificadorInterno.reanudarProceso(pedido.pid);
+			return;
+		}
+		break;
+	}
+	descartados++;
+}
+
+#endif // PLANIFICADOR_CONCURRENTE_H_
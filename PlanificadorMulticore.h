@@ -0,0 +1,386 @@
+#ifndef PLANIFICADOR_MULTICORE_H_
+#define PLANIFICADOR_MULTICORE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * Planificador para varios núcleos: un PlanificadorRR por trabajador, cada
+ * uno con su propio mutex, así que los trabajadores despachan en paralelo.
+ * Cuando un trabajador se queda sin procesos activos le roba a otro la
+ * mitad de sus activos, pero nunca más de MAXIMO_A_ROBAR por vez. El
+ * ladrón sólo usa try_lock: si la víctima está ocupada pasa a la
+ * siguiente, así que nunca espera a nadie, y la víctima espera a lo sumo
+ * lo que tarda en sacar MAXIMO_A_ROBAR procesos, sin importar cuántos
+ * tenga.
+ *
+ * Las operaciones sobre un proceso (eliminar, pausar, reanudar, consultar)
+ * buscan en qué trabajador está tomando los mutex de a uno. Si durante
+ * la búsqueda hubo un robo en curso, la repiten.
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia y operator==
+ * No se puede asumir que el tipo T tenga operator=
+ */
+template<typename T, typename Hash = typename HashPorDefecto<T>::tipo>
+class PlanificadorMulticore {
+
+  public:
+
+	explicit PlanificadorMulticore(int trabajadores);
+	~PlanificadorMulticore();
+	int cantidadDeTrabajadores() const;
+	void agregarProceso(const T&);
+	void agregarProceso(const T&, int trabajador);
+	void eliminarProceso(const T&);
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+	template<typename Funcion>
+	bool ejecutarSiguienteProceso(int trabajador, Funcion);
+	void detener();
+	void reanudar();
+	bool detenido() const;
+	bool esPlanificado(const T&) const;
+	bool estaActivo(const T&) const;
+	int trabajadorDe(const T&) const;
+	bool hayProcesos() const;
+	bool hayProcesosActivos() const;
+	int cantidadDeProcesos() const;
+	int cantidadDeProcesosActivos() const;
+	long cantidadDeRobos() const;
+
+  private:
+
+	PlanificadorMulticore(const PlanificadorMulticore<T, Hash>&);
+	PlanificadorMulticore<T, Hash>& operator=(const PlanificadorMulticore<T, Hash>&);
+
+	// Procesos que saca un robo como máximo, con el mutex de la víctima
+	static const int MAXIMO_A_ROBAR = 32;
+
+	// Cada trabajador en su propia línea de cache
+	struct alignas(64) Trabajador {
+		mutex cerrojo;
+		PlanificadorRR<T, Hash> planificador;
+		atomic<int> procesos;
+		atomic<int> activos;
+		Trabajador(): procesos(0), activos(0){}
+	};
+
+	template<typename Funcion>
+	bool conProceso(const T&, Funcion) const;
+	bool robar(int ladron);
+
+	Trabajador* trabajadores;
+	int cantidad;
+	atomic<unsigned int> siguienteTrabajador;
+	atomic<bool> planificadorDetenido;
+	// Un robo saca los procesos de la víctima antes de agregarlos al
+	// ladrón; mientras tanto no están en ningún trabajador.
+	atomic<long> robosIniciados;
+	atomic<long> robosTerminados;
+};
+
+/**
+ * Crea un planificador con la cantidad indicada de trabajadores.
+ * PRE: trabajadores > 0
+ */
+template<class T, class Hash>
+PlanificadorMulticore<T, Hash>::PlanificadorMulticore(int trabajadores):
+	siguienteTrabajador(0), planificadorDetenido(false), robosIniciados(0), robosTerminados(0){
+	assert(trabajadores > 0);
+	cantidad = trabajadores;
+	this->trabajadores = new Trabajador[trabajadores];
+}
+
+template<class T, class Hash>
+PlanificadorMulticore<T, Hash>::~PlanificadorMulticore(){
+	delete[] trabajadores;
+}
+
+template<class T, class Hash>
+int PlanificadorMulticore<T, Hash>::cantidadDeTrabajadores() const{
+	return cantidad;
+}
+
+/**
+ * Agrega un proceso activo, repartiendo los procesos nuevos entre los
+ * trabajadores por turnos.
+ * PRE: El proceso no está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+void PlanificadorMulticore<T, Hash>::agregarProceso(const T& p){
+	agregarProceso(p, siguienteTrabajador.fetch_add(1, memory_order_relaxed) % cantidad);
+}
+
+/**
+ * Agrega un proceso activo al trabajador indicado, inmediatamente antes
+ * de su proceso actual.
+ * PRE: El proceso no está siendo planificado por el planificador.
+ * PRE: 0 <= trabajador < cantidadDeTrabajadores()
+ */
+template<class T, class Hash>
+void PlanificadorMulticore<T, Hash>::agregarProceso(const T& p, int trabajador){
+	assert(0 <= trabajador && trabajador < cantidad);
+	assert(!esPlanificado(p));
+	Trabajador& t = trabajadores[trabajador];
+	lock_guard<mutex> cerrado(t.cerrojo);
+	t.planificador.agregarProceso(p);
+	t.procesos.fetch_add(1, memory_order_relaxed);
+	t.activos.fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+void PlanificadorMulticore<T, Hash>::eliminarProceso(const T& p){
+	bool encontrado = conProceso(p, [&p](Trabajador& t, int){
+		if(t.planificador.estaActivo(p)){
+			t.activos.fetch_sub(1, memory_order_relaxed);
+		}
+		t.planificador.eliminarProceso(p);
+		t.procesos.fetch_sub(1, memory_order_relaxed);
+	});
+	assert(encontrado);
+	(void)encontrado;
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está activo.
+ */
+template<class T, class Hash>
+void PlanificadorMulticore<T, Hash>::pausarProceso(const T& p){
+	bool encontrado = conProceso(p, [&p](Trabajador& t, int){
+		t.planificador.pausarProceso(p);
+		t.activos.fetch_sub(1, memory_order_relaxed);
+	});
+	assert(encontrado);
+	(void)encontrado;
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está inactivo.
+ */
+template<class T, class Hash>
+void PlanificadorMulticore<T, Hash>::reanudarProceso(const T& p){
+	bool encontrado = conProceso(p, [&p](Trabajador& t, int){
+		t.planificador.reanudarProceso(p);
+		t.activos.fetch_add(1, memory_order_relaxed);
+	});
+	assert(encontrado);
+	(void)encontrado;
+}
+
+/**
+ * Le pasa a alEjecutar el proceso actual del trabajador y procede a
+ * ejecutar el siguiente. Si el trabajador no tiene activos, primero
+ * intenta robarle procesos a otro. Devuelve false si no ejecutó nada
+ * (planificador detenido o ningún activo al alcance).
+ * alEjecutar se llama con el mutex del trabajador tomado: debería
+ * limitarse a copiar lo que necesite del proceso.
+ * PRE: 0 <= trabajador < cantidadDeTrabajadores()
+ */
+template<class T, class Hash>
+template<typename Funcion>
+bool PlanificadorMulticore<T, Hash>::ejecutarSiguienteProceso(int trabajador, Funcion alEjecutar){
+	assert(0 <= trabajador && trabajador < cantidad);
+	if(planificadorDetenido.load(memory_order_relaxed)){
+		return false;
+	}
+	Trabajador& t = trabajadores[trabajador];
+	for(int intento = 0; intento < 2; intento++){
+		{
+			lock_guard<mutex> cerrado(t.cerrojo);
+			if(t.planificador.hayProcesosActivos()){
+				alEjecutar(t.planificador.procesoEjecutado());
+				t.planificador.ejecutarSiguienteProceso();
+				return true;
+			}
+		}
+		if(intento == 0 && !robar(trabajador)){
+			return false;
+		}
+	}
+	return false;
+}
+
+/**
+ * Detiene la ejecución en todos los trabajadores.
+ * PRE: El planificador no está detenido.
+ */
+template<class T, class Hash>
+void PlanificadorMulticore<T, Hash>::detener(){
+	bool estaba = planificadorDetenido.exchange(true);
+	assert(!estaba);
+	(void)estaba;
+}
+
+/**
+ * Reanuda la ejecución en todos los trabajadores.
+ * PRE: El planificador está detenido.
+ */
+template<class T, class Hash>
+void PlanificadorMulticore<T, Hash>::reanudar(){
+	bool estaba = planificadorDetenido.exchange(false);
+	assert(estaba);
+	(void)estaba;
+}
+
+template<class T, class Hash>
+bool PlanificadorMulticore<T, Hash>::detenido() const{
+	return planificadorDetenido.load();
+}
+
+template<class T, class Hash>
+bool PlanificadorMulticore<T, Hash>::esPlanificado(const T& p) const{
+	return conProceso(p, [](Trabajador&, int){});
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+bool PlanificadorMulticore<T, Hash>::estaActivo(const T& p) const{
+	bool activo = false;
+	bool encontrado = conProceso(p, [&p, &activo](Trabajador& t, int){
+		activo = t.planificador.estaActivo(p);
+	});
+	assert(encontrado);
+	(void)encontrado;
+	return activo;
+}
+
+/**
+ * Devuelve el trabajador que tiene al proceso en este momento; un robo
+ * lo puede mover en cualquier momento.
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+int PlanificadorMulticore<T, Hash>::trabajadorDe(const T& p) const{
+	int trabajador = -1;
+	conProceso(p, [&trabajador](Trabajador&, int i){
+		trabajador = i;
+	});
+	assert(trabajador >= 0);
+	return trabajador;
+}
+
+template<class T, class Hash>
+bool PlanificadorMulticore<T, Hash>::hayProcesos() const{
+	return cantidadDeProcesos() > 0;
+}
+
+template<class T, class Hash>
+bool PlanificadorMulticore<T, Hash>::hayProcesosActivos() const{
+	return cantidadDeProcesosActivos() > 0;
+}
+
+/**
+ * Suma los contadores de los trabajadores sin tomar sus mutex. Con robos
+ * en curso puede no contar los procesos que están cambiando de trabajador.
+ */
+template<class T, class Hash>
+int PlanificadorMulticore<T, Hash>::cantidadDeProcesos() const{
+	int total = 0;
+	for(int i = 0; i < cantidad; i++){
+		total += trabajadores[i].procesos.load(memory_order_relaxed);
+	}
+	return total;
+}
+
+/**
+ * Ídem cantidadDeProcesos, para los activos.
+ */
+template<class T, class Hash>
+int PlanificadorMulticore<T, Hash>::cantidadDeProcesosActivos() const{
+	int total = 0;
+	for(int i = 0; i < cantidad; i++){
+		total += trabajadores[i].activos.load(memory_order_relaxed);
+	}
+	return total;
+}
+
+template<class T, class Hash>
+long PlanificadorMulticore<T, Hash>::cantidadDeRobos() const{
+	return robosTerminados.load(memory_order_relaxed);
+}
+
+//Metodos auxiliares
+
+/**
+ * Busca al trabajador que tiene al proceso y, con su mutex tomado, le
+ * aplica f(trabajador, número). Devuelve false si no está planificado.
+ * Un "no está" sólo vale si ningún robo empezó sin terminar mientras
+ * se buscaba; si no, se busca de nuevo.
+ */
+template<class T, class Hash>
+template<typename Funcion>
+bool PlanificadorMulticore<T, Hash>::conProceso(const T& p, Funcion f) const{
+	while(true){
+		long terminados = robosTerminados.load();
+		for(int i = 0; i < cantidad; i++){
+			Trabajador& t = trabajadores[i];
+			lock_guard<mutex> cerrado(t.cerrojo);
+			if(t.planificador.esPlanificado(p)){
+				f(t, i);
+				return true;
+			}
+		}
+		if(robosIniciados.load() == terminados){
+			return false;
+		}
+		this_thread::yield();
+	}
+}
+
+/**
+ * Le roba al primer trabajador con al menos dos activos que no esté
+ * ocupado la mitad de sus activos, hasta MAXIMO_A_ROBAR, empezando por su
+ * proceso actual. Devuelve true si robó algo.
+ */
+template<class T, class Hash>
+bool PlanificadorMulticore<T, Hash>::robar(int ladron){
+	for(int k = 1; k < cantidad; k++){
+		Trabajador& victima = trabajadores[(ladron + k) % cantidad];
+		if(victima.activos.load(memory_order_relaxed) < 2){
+			continue;
+		}
+		unique_lock<mutex> cerradoVictima(victima.cerrojo, try_to_lock);
+		if(!cerradoVictima.owns_lock()){
+			continue;
+		}
+		int aRobar = min(victima.planificador.cantidadDeProcesosActivos() / 2, (int)MAXIMO_A_ROBAR);
+		if(aRobar == 0){
+			continue;
+		}
+		robosIniciados.fetch_add(1);
+		vector<T> robados;
+		robados.reserve(aRobar);
+		for(int i = 0; i < aRobar; i++){
+			robados.push_back(victima.planificador.procesoEjecutado());
+			victima.planificador.eliminarProceso(robados.back());
+		}
+		victima.procesos.fetch_sub(aRobar, memory_order_relaxed);
+		victima.activos.fetch_sub(aRobar, memory_order_relaxed);
+		cerradoVictima.unlock();
+
+		Trabajador& t = trabajadores[ladron];
+		{
+			lock_guard<mutex> cerrado(t.cerrojo);
+			t.planificador.agregarProcesos(robados.begin(), robados.end());
+			t.procesos.fetch_add(aRobar, memory_order_relaxed);
+			t.activos.fetch_add(aRobar, memory_order_relaxed);
+		}
+		robosTerminados.fetch_add(1);
+		return true;
+	}
+	return false;
+}
+
+#endif // PLANIFICADOR_MULTICORE_H_
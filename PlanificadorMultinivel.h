@@ -0,0 +1,386 @@
+#ifndef PLANIFICADOR_MULTINIVEL_H_
+#define PLANIFICADOR_MULTINIVEL_H_
+
+#include <stdint.h>
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * Planificador multinivel con realimentación: un PlanificadorRR por
+ * nivel de prioridad, donde el nivel 0 es el más prioritario. Siempre se
+ * ejecuta el proceso actual del nivel más prioritario que tenga procesos
+ * activos, y dentro de cada nivel se sigue el orden Round Robin.
+ *
+ * Un bit por nivel indica si tiene activos, así que encontrar el nivel en
+ * ejecución es un find-first-set sobre una palabra de 64 bits, O(1) sin
+ * importar la cantidad de niveles.
+ *
+ * Detener, reanudar, pausar y reanudar procesos valen igual que en
+ * PlanificadorRR, para todos los niveles a la vez.
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia y operator==
+ * No se puede asumir que el tipo T tenga operator=
+ */
+template<typename T, int Niveles = 8, typename Hash = typename HashPorDefecto<T>::tipo>
+class PlanificadorMultinivel {
+
+	static_assert(Niveles >= 1 && Niveles <= 64, "Un bit por nivel en una palabra de 64");
+
+  public:
+
+	PlanificadorMultinivel();
+	void agregarProceso(const T&, int nivel = 0);
+	void eliminarProceso(const T&);
+	int nivelDe(const T&) const;
+	int nivelEjecutado() const;
+	void cambiarNivel(const T&, int nivel);
+	void degradar(const T&);
+	void impulsar();
+	const T& procesoEjecutado() const;
+	void ejecutarSiguienteProceso();
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+	void detener();
+	void reanudar();
+	bool detenido() const;
+	bool esPlanificado(const T&) const;
+	bool estaActivo(const T&) const;
+	bool hayProcesos() const;
+	bool hayProcesosActivos() const;
+	int cantidadDeProcesos() const;
+	int cantidadDeProcesosActivos() const;
+	bool operator==(const PlanificadorMultinivel<T, Niveles, Hash>&) const;
+	ostream& mostrarPlanificadorRR(ostream&) const;
+
+  private:
+
+	/**
+	 * Nivel de un proceso según el índice. Si se registró antes del último
+	 * impulso, en realidad está en el nivel 0.
+	 */
+	struct Ubicacion {
+		int nivel;
+		unsigned int impulso;
+	};
+
+	void actualizarOcupacion(int nivel);
+	void mover(const T&, int desde, int hasta);
+
+	PlanificadorRR<T, Hash> niveles[Niveles];
+	// Bit i prendido sii el nivel i tiene procesos activos
+	uint64_t ocupados;
+	int cantidadProcesos;
+	int cantidadActivos;
+	unsigned int impulsos;
+	bool planificadorDetenido;
+	IndiceDeProcesos<T, Ubicacion, Hash> indice;
+};
+
+/**
+ * Crea un nuevo planificador multinivel.
+ */
+template<class T, int Niveles, class Hash>
+PlanificadorMultinivel<T, Niveles, Hash>::PlanificadorMultinivel(){
+	ocupados = 0;
+	cantidadProcesos = 0;
+	cantidadActivos = 0;
+	impulsos = 0;
+	planificadorDetenido = false;
+}
+
+/**
+ * Agrega un proceso activo al nivel indicado, inmediatamente antes del
+ * proceso actual de ese nivel.
+ * PRE: El proceso no está siendo planificado por el planificador.
+ * PRE: 0 <= nivel < Niveles
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::agregarProceso(const T& p, int nivel){
+	assert(0 <= nivel && nivel < Niveles);
+	assert(!esPlanificado(p));
+	niveles[nivel].agregarProceso(p);
+	Ubicacion u = {nivel, impulsos};
+	indice.insertar(p, u);
+	ocupados |= (uint64_t)1 << nivel;
+	cantidadProcesos++;
+	cantidadActivos++;
+}
+
+/**
+ * Elimina un proceso. Si estaba en ejecución, pasa a ejecutarse el
+ * siguiente activo de su nivel o, si no queda ninguno, el del siguiente
+ * nivel con activos.
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::eliminarProceso(const T& p){
+	int nivel = nivelDe(p);
+	if(niveles[nivel].estaActivo(p)){
+		cantidadActivos--;
+	}
+	// p puede ser una referencia al proceso que se elimina del nivel
+	indice.borrar(p);
+	niveles[nivel].eliminarProceso(p);
+	actualizarOcupacion(nivel);
+	cantidadProcesos--;
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, int Niveles, class Hash>
+int PlanificadorMultinivel<T, Niveles, Hash>::nivelDe(const T& p) const{
+	if(indice.habilitado){
+		Ubicacion ausente = {-1, 0};
+		Ubicacion u = indice.buscar(p, ausente);
+		assert(u.nivel >= 0);
+		return u.impulso == impulsos ? u.nivel : 0;
+	}
+	for(int nivel = 0; nivel < Niveles; nivel++){
+		if(niveles[nivel].esPlanificado(p)){
+			return nivel;
+		}
+	}
+	assert(false);
+	return -1;
+}
+
+/**
+ * Devuelve el nivel del proceso en ejecución.
+ * PRE: Hay al menos un proceso activo en el planificador.
+ */
+template<class T, int Niveles, class Hash>
+int PlanificadorMultinivel<T, Niveles, Hash>::nivelEjecutado() const{
+	assert(ocupados != 0);
+	return __builtin_ctzll(ocupados);
+}
+
+/**
+ * Mueve un proceso a otro nivel, inmediatamente antes del proceso actual
+ * de ese nivel. Conserva si está pausado.
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: 0 <= nivel < Niveles
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::cambiarNivel(const T& p, int nivel){
+	assert(0 <= nivel && nivel < Niveles);
+	int actual = nivelDe(p);
+	if(actual != nivel){
+		mover(p, actual, nivel);
+	}
+}
+
+/**
+ * Baja un proceso al nivel siguiente, si no está en el último. Es lo que
+ * corresponde cuando un proceso agota su quantum.
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::degradar(const T& p){
+	int actual = nivelDe(p);
+	if(actual + 1 < Niveles){
+		mover(p, actual, actual + 1);
+	}
+}
+
+/**
+ * Sube todos los procesos al nivel 0, nivel por nivel, para que los que
+ * quedaron abajo no se mueran de hambre. Cuesta lo que copiar los
+ * procesos de los niveles inferiores; el índice no se recorre.
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::impulsar(){
+	for(int nivel = 1; nivel < Niveles; nivel++){
+		niveles[0].absorber(niveles[nivel]);
+	}
+	ocupados = niveles[0].hayProcesosActivos() ? 1 : 0;
+	impulsos++;
+}
+
+/**
+ * Devuelve el proceso actual del nivel más prioritario con activos.
+ * PRE: Hay al menos un proceso activo en el planificador.
+ */
+template<class T, int Niveles, class Hash>
+const T& PlanificadorMultinivel<T, Niveles, Hash>::procesoEjecutado() const{
+	return niveles[nivelEjecutado()].procesoEjecutado();
+}
+
+/**
+ * Procede a ejecutar el siguiente proceso activo del nivel en ejecución.
+ * PRE: Hay al menos un proceso activo en el planificador.
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::ejecutarSiguienteProceso(){
+	niveles[nivelEjecutado()].ejecutarSiguienteProceso();
+}
+
+/**
+ * Pausa un proceso. Si estaba en ejecución, pasa a ejecutarse el
+ * siguiente activo de su nivel o del siguiente nivel con activos.
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está activo.
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::pausarProceso(const T& p){
+	int nivel = nivelDe(p);
+	niveles[nivel].pausarProceso(p);
+	actualizarOcupacion(nivel);
+	cantidadActivos--;
+}
+
+/**
+ * Reanuda un proceso pausado. Si su nivel no tenía activos, pasa a ser
+ * el proceso actual de ese nivel.
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está inactivo.
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::reanudarProceso(const T& p){
+	int nivel = nivelDe(p);
+	niveles[nivel].reanudarProceso(p);
+	ocupados |= (uint64_t)1 << nivel;
+	cantidadActivos++;
+}
+
+/**
+ * Detiene la ejecución de todos los procesos de todos los niveles.
+ * PRE: El planificador no está detenido.
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::detener(){
+	assert(!planificadorDetenido);
+	planificadorDetenido = true;
+}
+
+/**
+ * Reanuda la ejecución de los procesos (activos).
+ * PRE: El planificador está detenido.
+ */
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::reanudar(){
+	assert(planificadorDetenido);
+	planificadorDetenido = false;
+}
+
+template<class T, int Niveles, class Hash>
+bool PlanificadorMultinivel<T, Niveles, Hash>::detenido() const{
+	return planificadorDetenido;
+}
+
+template<class T, int Niveles, class Hash>
+bool PlanificadorMultinivel<T, Niveles, Hash>::esPlanificado(const T& p) const{
+	if(indice.habilitado){
+		Ubicacion ausente = {-1, 0};
+		return indice.buscar(p, ausente).nivel >= 0;
+	}
+	for(int nivel = 0; nivel < Niveles; nivel++){
+		if(niveles[nivel].esPlanificado(p)){
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, int Niveles, class Hash>
+bool PlanificadorMultinivel<T, Niveles, Hash>::estaActivo(const T& p) const{
+	return niveles[nivelDe(p)].estaActivo(p);
+}
+
+template<class T, int Niveles, class Hash>
+bool PlanificadorMultinivel<T, Niveles, Hash>::hayProcesos() const{
+	return cantidadProcesos > 0;
+}
+
+template<class T, int Niveles, class Hash>
+bool PlanificadorMultinivel<T, Niveles, Hash>::hayProcesosActivos() const{
+	return ocupados != 0;
+}
+
+template<class T, int Niveles, class Hash>
+int PlanificadorMultinivel<T, Niveles, Hash>::cantidadDeProcesos() const{
+	return cantidadProcesos;
+}
+
+template<class T, int Niveles, class Hash>
+int PlanificadorMultinivel<T, Niveles, Hash>::cantidadDeProcesosActivos() const{
+	return cantidadActivos;
+}
+
+/**
+ * Devuelve true si cada nivel es igual al del otro planificador.
+ */
+template<class T, int Niveles, class Hash>
+bool PlanificadorMultinivel<T, Niveles, Hash>::operator==(const PlanificadorMultinivel<T, Niveles, Hash>& p) const{
+	if(cantidadProcesos != p.cantidadProcesos || ocupados != p.ocupados
+			|| planificadorDetenido != p.planificadorDetenido){
+		return false;
+	}
+	for(int nivel = 0; nivel < Niveles; nivel++){
+		if(!(niveles[nivel] == p.niveles[nivel])){
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Muestra los niveles que tienen procesos, cada uno con el formato de
+ * PlanificadorRR::mostrarPlanificadorRR. Por ejemplo:
+ * {0: [1*, 2], 3: [4 (i)]}
+ */
+template<class T, int Niveles, class Hash>
+ostream& PlanificadorMultinivel<T, Niveles, Hash>::mostrarPlanificadorRR(ostream& os) const{
+	os << "{";
+	bool primero = true;
+	for(int nivel = 0; nivel < Niveles; nivel++){
+		if(!niveles[nivel].hayProcesos()){
+			continue;
+		}
+		if(!primero){
+			os << ", ";
+		}
+		os << nivel << ": ";
+		niveles[nivel].mostrarPlanificadorRR(os);
+		primero = false;
+	}
+	os << "}";
+	return os;
+}
+
+template<class T, int Niveles, class Hash>
+ostream& operator<<(ostream& out, const PlanificadorMultinivel<T, Niveles, Hash>& a) {
+	return a.mostrarPlanificadorRR(out);
+}
+
+//Metodos auxiliares
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::actualizarOcupacion(int nivel){
+	uint64_t bit = (uint64_t)1 << nivel;
+	if(niveles[nivel].hayProcesosActivos()){
+		ocupados |= bit;
+	}else{
+		ocupados &= ~bit;
+	}
+}
+
+template<class T, int Niveles, class Hash>
+void PlanificadorMultinivel<T, Niveles, Hash>::mover(const T& p, int desde, int hasta){
+	// p puede ser una referencia al proceso que se elimina del nivel
+	T pid(p);
+	bool activo = niveles[desde].estaActivo(pid);
+	niveles[desde].eliminarProceso(pid);
+	actualizarOcupacion(desde);
+	niveles[hasta].agregarProceso(pid);
+	if(!activo){
+		niveles[hasta].pausarProceso(pid);
+	}
+	actualizarOcupacion(hasta);
+	Ubicacion u = {hasta, impulsos};
+	indice.insertar(pid, u);
+}
+
+#endif // PLANIFICADOR_MULTINIVEL_H_
@@ -0,0 +1,401 @@
+#ifndef PLANIFICADOR_POR_GRUPOS_H_
+#define PLANIFICADOR_POR_GRUPOS_H_
+
+#include <list>
+#include <unordered_map>
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * Planificador Round Robin de procesos agrupados (por ejemplo, los de un
+ * mismo trabajo). Todos los procesos se turnan en un único PlanificadorRR,
+ * en el mismo orden que tendrían sin grupos: cada proceso ejecutable
+ * recibe un turno por vuelta, sin importar el tamaño de su grupo.
+ *
+ * Un proceso se ejecuta sólo si él y su grupo están activos. Pausar o
+ * reanudar un grupo cuesta O(1): cambia la marca del grupo y la cantidad
+ * de ejecutables, sin tocar a sus procesos. El despacho saltea a los
+ * procesos activos de grupos pausados, así que cuesta O(1) más los que
+ * saltea; como cada grupo sabe cuántos activos tiene, nunca da vueltas
+ * de más cuando no queda nada ejecutable.
+ *
+ * Un grupo existe mientras tenga procesos; al eliminar el último se
+ * olvida también si estaba pausado.
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia y operator==
+ * No se puede asumir que el tipo T tenga operator=
+ * G tiene que tener hash<G> y constructor por defecto.
+ */
+template<typename T, typename G = int, typename Hash = typename HashPorDefecto<T>::tipo>
+class PlanificadorPorGrupos {
+
+  public:
+
+	PlanificadorPorGrupos();
+	void agregarProceso(const T&, const G&);
+	void eliminarProceso(const T&);
+	const G& grupoDe(const T&) const;
+	void pausarGrupo(const G&);
+	void reanudarGrupo(const G&);
+	bool existeGrupo(const G&) const;
+	bool grupoPausado(const G&) const;
+	int cantidadDeGrupos() const;
+	const T& procesoEjecutado() const;
+	void ejecutarSiguienteProceso();
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+	void detener();
+	void reanudar();
+	bool detenido() const;
+	bool esPlanificado(const T&) const;
+	bool estaActivo(const T&) const;
+	bool esEjecutable(const T&) const;
+	bool hayProcesos() const;
+	bool hayProcesosActivos() const;
+	int cantidadDeProcesos() const;
+	int cantidadDeProcesosActivos() const;
+	ostream& mostrarPlanificadorRR(ostream&) const;
+
+  private:
+
+	PlanificadorPorGrupos<T, G, Hash>& operator=(const PlanificadorPorGrupos<T, G, Hash>& otra) {
+		assert(false);
+		return *this;
+	}
+
+	struct Grupo {
+		int cantidadProcesos;
+		// Procesos del grupo activos por su estado propio
+		int cantidadActivos;
+		bool pausado;
+		Grupo(): cantidadProcesos(0), cantidadActivos(0), pausado(false){}
+	};
+
+	typedef unordered_map<G, Grupo> Grupos;
+
+	Grupo& grupo(const G&);
+	const Grupo& grupo(const G&) const;
+	void saltarPausados();
+
+	// Todos los procesos en orden de ejecución, activos según su estado propio
+	PlanificadorRR<T, Hash> orden;
+	Grupos grupos;
+	// Procesos activos de grupos no pausados
+	int cantidadEjecutables;
+	IndiceDeProcesos<T, G, Hash> indice;
+	// Sin hash no hay índice: el grupo de cada proceso se busca recorriendo
+	list<pair<T, G> > gruposSinIndice;
+};
+
+/**
+ * Crea un nuevo planificador sin grupos.
+ */
+template<class T, class G, class Hash>
+PlanificadorPorGrupos<T, G, Hash>::PlanificadorPorGrupos(){
+	cantidadEjecutables = 0;
+}
+
+/**
+ * Agrega un proceso activo al grupo indicado, inmediatamente antes del
+ * proceso actual. Si el grupo no existía, se crea activo.
+ * PRE: El proceso no está siendo planificado por el planificador.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::agregarProceso(const T& p, const G& g){
+	assert(!esPlanificado(p));
+	Grupo& destino = grupos[g];
+	destino.cantidadProcesos++;
+	destino.cantidadActivos++;
+	if(!destino.pausado){
+		cantidadEjecutables++;
+	}
+	if(indice.habilitado){
+		indice.insertar(p, g);
+	}else{
+		gruposSinIndice.push_back(pair<T, G>(p, g));
+	}
+	orden.agregarProceso(p);
+	saltarPausados();
+}
+
+/**
+ * Elimina un proceso. Si era el último de su grupo, elimina el grupo.
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::eliminarProceso(const T& p){
+	// p puede ser una referencia al proceso del orden, que se suelta último
+	G g(grupoDe(p));
+	Grupo& origen = grupo(g);
+	if(orden.estaActivo(p)){
+		origen.cantidadActivos--;
+		if(!origen.pausado){
+			cantidadEjecutables--;
+		}
+	}
+	if(--origen.cantidadProcesos == 0){
+		grupos.erase(g);
+	}
+	if(indice.habilitado){
+		indice.borrar(p);
+	}else{
+		typename list<pair<T, G> >::iterator it = gruposSinIndice.begin();
+		while(!(it->first == p)){
+			++it;
+		}
+		gruposSinIndice.erase(it);
+	}
+	orden.eliminarProceso(p);
+	saltarPausados();
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class G, class Hash>
+const G& PlanificadorPorGrupos<T, G, Hash>::grupoDe(const T& p) const{
+	typename Grupos::const_iterator it;
+	if(indice.habilitado){
+		// El índice guarda una copia del grupo; se devuelve la del mapa
+		it = grupos.find(indice.buscar(p, G()));
+	}else{
+		typename list<pair<T, G> >::const_iterator proceso = gruposSinIndice.begin();
+		while(proceso != gruposSinIndice.end() && !(proceso->first == p)){
+			++proceso;
+		}
+		assert(proceso != gruposSinIndice.end());
+		it = grupos.find(proceso->second);
+	}
+	assert(it != grupos.end());
+	return it->first;
+}
+
+/**
+ * Pausa todos los procesos del grupo a la vez, sin cambiar el estado
+ * propio de cada uno. Si se estaba ejecutando un proceso del grupo, pasa
+ * a ejecutarse el siguiente proceso ejecutable.
+ * PRE: El grupo existe y no está pausado.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::pausarGrupo(const G& g){
+	Grupo& pausado = grupo(g);
+	assert(!pausado.pausado);
+	pausado.pausado = true;
+	cantidadEjecutables -= pausado.cantidadActivos;
+	saltarPausados();
+}
+
+/**
+ * Vuelve a dejar ejecutar a los procesos activos del grupo, que nunca
+ * dejaron su lugar en el orden de ejecución.
+ * PRE: El grupo existe y está pausado.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::reanudarGrupo(const G& g){
+	Grupo& reanudado = grupo(g);
+	assert(reanudado.pausado);
+	reanudado.pausado = false;
+	cantidadEjecutables += reanudado.cantidadActivos;
+	saltarPausados();
+}
+
+template<class T, class G, class Hash>
+bool PlanificadorPorGrupos<T, G, Hash>::existeGrupo(const G& g) const{
+	return grupos.find(g) != grupos.end();
+}
+
+/**
+ * PRE: El grupo existe.
+ */
+template<class T, class G, class Hash>
+bool PlanificadorPorGrupos<T, G, Hash>::grupoPausado(const G& g) const{
+	return grupo(g).pausado;
+}
+
+template<class T, class G, class Hash>
+int PlanificadorPorGrupos<T, G, Hash>::cantidadDeGrupos() const{
+	return (int)grupos.size();
+}
+
+/**
+ * Devuelve el proceso actual. Si no hay nada que ejecutar, puede ser un
+ * proceso pausado o de un grupo pausado.
+ * PRE: Hay al menos un proceso en el planificador.
+ */
+template<class T, class G, class Hash>
+const T& PlanificadorPorGrupos<T, G, Hash>::procesoEjecutado() const{
+	return orden.procesoEjecutado();
+}
+
+/**
+ * Pasa a ejecutarse el siguiente proceso ejecutable, salteando a los
+ * activos de grupos pausados.
+ * PRE: Hay al menos un proceso ejecutable en el planificador.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::ejecutarSiguienteProceso(){
+	assert(cantidadEjecutables > 0);
+	orden.ejecutarSiguienteProceso();
+	saltarPausados();
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está activo.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::pausarProceso(const T& p){
+	Grupo& destino = grupo(grupoDe(p));
+	destino.cantidadActivos--;
+	if(!destino.pausado){
+		cantidadEjecutables--;
+	}
+	orden.pausarProceso(p);
+	saltarPausados();
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está inactivo.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::reanudarProceso(const T& p){
+	Grupo& destino = grupo(grupoDe(p));
+	destino.cantidadActivos++;
+	if(!destino.pausado){
+		cantidadEjecutables++;
+	}
+	orden.reanudarProceso(p);
+	saltarPausados();
+}
+
+/**
+ * Detiene la ejecución de todos los procesos.
+ * PRE: El planificador no está detenido.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::detener(){
+	orden.detener();
+}
+
+/**
+ * Reanuda la ejecución de los procesos (ejecutables).
+ * PRE: El planificador está detenido.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::reanudar(){
+	orden.reanudar();
+}
+
+template<class T, class G, class Hash>
+bool PlanificadorPorGrupos<T, G, Hash>::detenido() const{
+	return orden.detenido();
+}
+
+template<class T, class G, class Hash>
+bool PlanificadorPorGrupos<T, G, Hash>::esPlanificado(const T& p) const{
+	return orden.esPlanificado(p);
+}
+
+/**
+ * Devuelve el estado propio del proceso, sin importar el de su grupo.
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class G, class Hash>
+bool PlanificadorPorGrupos<T, G, Hash>::estaActivo(const T& p) const{
+	return orden.estaActivo(p);
+}
+
+/**
+ * Devuelve true si el proceso y su grupo están activos.
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class G, class Hash>
+bool PlanificadorPorGrupos<T, G, Hash>::esEjecutable(const T& p) const{
+	return !grupo(grupoDe(p)).pausado && orden.estaActivo(p);
+}
+
+template<class T, class G, class Hash>
+bool PlanificadorPorGrupos<T, G, Hash>::hayProcesos() const{
+	return orden.hayProcesos();
+}
+
+/**
+ * Devuelve true si hay algún proceso ejecutable.
+ */
+template<class T, class G, class Hash>
+bool PlanificadorPorGrupos<T, G, Hash>::hayProcesosActivos() const{
+	return cantidadEjecutables > 0;
+}
+
+template<class T, class G, class Hash>
+int PlanificadorPorGrupos<T, G, Hash>::cantidadDeProcesos() const{
+	return orden.cantidadDeProcesos();
+}
+
+/**
+ * Cuenta los procesos ejecutables: activos y de grupos activos.
+ */
+template<class T, class G, class Hash>
+int PlanificadorPorGrupos<T, G, Hash>::cantidadDeProcesosActivos() const{
+	return cantidadEjecutables;
+}
+
+/**
+ * Muestra los procesos en orden de ejecución desde el actual, cada uno
+ * como en PlanificadorRR::mostrarPlanificadorRR según su estado propio y
+ * seguido de su grupo, con " (i)" si el grupo está pausado. Por ejemplo:
+ * [5*: 2, 3: 1 (i), 4 (i): 1, 6: 2]
+ */
+template<class T, class G, class Hash>
+ostream& PlanificadorPorGrupos<T, G, Hash>::mostrarPlanificadorRR(ostream& os) const{
+	os << "[";
+	bool primero = true;
+	orden.recorrerProcesos([this, &os, &primero](const T& p, bool pausado){
+		if(!primero){
+			os << ", ";
+		}
+		const G& g = grupoDe(p);
+		os << p << (pausado ? " (i)" : primero ? "*" : "");
+		os << ": " << g << (grupo(g).pausado ? " (i)" : "");
+		primero = false;
+	});
+	os << "]";
+	return os;
+}
+
+template<class T, class G, class Hash>
+ostream& operator<<(ostream& out, const PlanificadorPorGrupos<T, G, Hash>& a) {
+	return a.mostrarPlanificadorRR(out);
+}
+
+//Metodos auxiliares
+/**
+ * PRE: El grupo existe.
+ */
+template<class T, class G, class Hash>
+typename PlanificadorPorGrupos<T, G, Hash>::Grupo& PlanificadorPorGrupos<T, G, Hash>::grupo(const G& g){
+	typename Grupos::iterator it = grupos.find(g);
+	assert(it != grupos.end());
+	return it->second;
+}
+
+template<class T, class G, class Hash>
+const typename PlanificadorPorGrupos<T, G, Hash>::Grupo& PlanificadorPorGrupos<T, G, Hash>::grupo(const G& g) const{
+	typename Grupos::const_iterator it = grupos.find(g);
+	assert(it != grupos.end());
+	return it->second;
+}
+
+/**
+ * Mientras haya algo ejecutable, pasa al siguiente proceso activo si el
+ * actual es de un grupo pausado. Deja como actual a uno ejecutable.
+ */
+template<class T, class G, class Hash>
+void PlanificadorPorGrupos<T, G, Hash>::saltarPausados(){
+	while(cantidadEjecutables > 0 && grupo(grupoDe(orden.procesoEjecutado())).pausado){
+		orden.ejecutarSiguienteProceso();
+	}
+}
+
+#endif // PLANIFICADOR_POR_GRUPOS_H_
@@ -3,24 +3,188 @@
 
 #include <iostream>
 #include <cassert>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <memory>
+#include <new>
+#include <iterator>
+#include <initializer_list>
+#include <atomic>
+#include <utility>
+#include <stdint.h>
+#include <climits>
+#include <charconv>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include "ArbolDePosiciones.h"
+#include "AsignadorPool.h"
+#include "EstadisticasPlanificador.h"
 using namespace std;
 
+/**
+ * Marca que indica que no hay función de hash para el tipo de los procesos.
+ * En ese caso el planificador no mantiene índice y las búsquedas recorren
+ * la lista circular.
+ */
+struct SinHash {};
+
+/**
+ * Elige hash<T> si está disponible para T, o SinHash si no lo está.
+ */
+template<typename T, bool = is_default_constructible<hash<T> >::value>
+struct HashPorDefecto {
+	typedef hash<T> tipo;
+};
+
+template<typename T>
+struct HashPorDefecto<T, false> {
+	typedef SinHash tipo;
+};
+
+/**
+ * Los pids enteros se muestran con to_chars, sin pasar por el ostream.
+ * Los de un byte (char, bool) quedan afuera porque << no los muestra
+ * como números, y los caracteres anchos porque to_chars no los acepta.
+ */
+template<typename T>
+struct SeMuestraConToChars {
+	static const bool valor = is_integral<T>::value && sizeof(T) > 1 && !is_same<T, wchar_t>::value
+		&& !is_same<T, char16_t>::value && !is_same<T, char32_t>::value;
+};
+
+/**
+ * Índice de la ubicación (un Nodo* o una posición) de cada proceso por pid.
+ * Las búsquedas, inserciones y borrados cuestan O(1) esperado.
+ */
+template<typename T, typename Ubicacion, typename Hash>
+class IndiceDeProcesos {
+
+  public:
+
+	static const bool habilitado = true;
+
+	/**
+	 * Devuelve la ubicación de p, o ausente si no está indexado.
+	 */
+	Ubicacion buscar(const T& p, Ubicacion ausente) const {
+		typename unordered_map<T, Ubicacion, Hash>::const_iterator it = tabla.find(p);
+		return it == tabla.end() ? ausente : it->second;
+	}
+	void insertar(const T& p, Ubicacion u) { tabla[p] = u; }
+	void borrar(const T& p) { tabla.erase(p); }
+	void reservar(size_t n) { tabla.reserve(n); }
+	void vaciar() { tabla.clear(); }
+
+  private:
+
+	unordered_map<T, Ubicacion, Hash> tabla;
+};
+
+/**
+ * Sin hash no hay índice: el planificador busca recorriendo la lista.
+ */
+template<typename T, typename Ubicacion>
+class IndiceDeProcesos<T, Ubicacion, SinHash> {
+
+  public:
+
+	static const bool habilitado = false;
+
+	Ubicacion buscar(const T&, Ubicacion ausente) const { return ausente; }
+	void insertar(const T&, Ubicacion) {}
+	void borrar(const T&) {}
+	void reservar(size_t) {}
+	void vaciar() {}
+};
+
+/**
+ * Huella de los pids para la huella del planificador. Sin hash todos los
+ * pids tienen la misma huella y la del planificador no discrimina nada.
+ */
+inline uint64_t mezclarHuella(uint64_t x) {
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ull;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBull;
+	x ^= x >> 31;
+	return x;
+}
+
+template<typename T, typename Hash>
+struct HuellaDeProcesos {
+	static const bool habilitada = true;
+	static uint64_t de(const T& p) { return mezclarHuella(Hash()(p)); }
+};
+
+template<typename T>
+struct HuellaDeProcesos<T, SinHash> {
+	static const bool habilitada = false;
+	static uint64_t de(const T&) { return 0; }
+};
+
 /**
  * Se puede asumir que el tipo T tiene constructor por copia y operator==
  * No se puede asumir que el tipo T tenga operator=
+ *
+ * Hash es la función de hash usada para indexar los procesos. Por defecto
+ * es hash<T> si existe; para los tipos sin hash (SinHash) las búsquedas
+ * recorren la lista circular en O(n).
+ *
+ * Además de los anillos, los procesos están en un árbol de posiciones
+ * (ver ArbolDePosiciones.h) para ir a una posición del orden de ejecución
+ * en O(log n). Mantenerlo hace que agregar, eliminar, pausar y reanudar
+ * cuesten O(log n) esperado.
+ *
+ * Asignador es el allocator del que salen los nodos (se usa su rebind a
+ * Nodo). AsignadorPool los sirve desde bloques contiguos.
+ *
+ * Estadisticas es la política de instrumentación. Con SinEstadisticas
+ * (por defecto) no ocupa lugar ni agrega código; con EstadisticasAtomicas
+ * cuenta llamadas, saltos entre nodos y asignaciones, y mide latencias,
+ * todo consultable con estadisticas().
  */
-template<typename T>
-class PlanificadorRR {
+template<typename T, typename Hash = typename HashPorDefecto<T>::tipo,
+	typename Asignador = allocator<T>, typename Estadisticas = SinEstadisticas>
+class PlanificadorRR : private Estadisticas {
 
   public:
 
 	PlanificadorRR();
-	PlanificadorRR(const PlanificadorRR<T>&);
+	explicit PlanificadorRR(const Asignador&);
+	template<typename Iterador>
+	PlanificadorRR(Iterador, Iterador);
+	PlanificadorRR(initializer_list<T>);
+	PlanificadorRR(const PlanificadorRR<T, Hash, Asignador, Estadisticas>&);
+	PlanificadorRR(PlanificadorRR<T, Hash, Asignador, Estadisticas>&&) noexcept;
 	~PlanificadorRR();
+	PlanificadorRR<T, Hash, Asignador, Estadisticas>& operator=(PlanificadorRR<T, Hash, Asignador, Estadisticas>&&) noexcept;
 	void agregarProceso(const T&);
+	void agregarProceso(T&&);
+	template<typename... Argumentos>
+	void emplaceProceso(Argumentos&&...);
+	template<typename Iterador>
+	void agregarProcesos(Iterador, Iterador);
+	void absorber(PlanificadorRR<T, Hash, Asignador, Estadisticas>&);
 	void eliminarProceso(const T&);
+	template<typename Iterador>
+	void eliminarProcesos(Iterador, Iterador);
+	void eliminarProcesoDiferido(const T&);
+	int compactar(int);
+	int cantidadDeProcesosPorCompactar() const;
+	template<typename Predicado>
+	void pausarSi(Predicado);
+	template<typename Predicado>
+	void reanudarSi(Predicado);
+	void vaciar();
 	const T& procesoEjecutado() const;
 	void ejecutarSiguienteProceso();
+	void ejecutarSiguientes(long);
+	template<typename Salida>
+	Salida proximosProcesos(int, Salida) const;
+	template<typename Funcion>
+	void recorrerProcesos(Funcion) const;
 	void pausarProceso(const T&);
 	void reanudarProceso(const T&);
 	void detener();
@@ -32,89 +196,335 @@ class PlanificadorRR {
 	bool hayProcesosActivos() const;
 	int cantidadDeProcesos() const;
 	int cantidadDeProcesosActivos() const;
-	bool operator==(const PlanificadorRR<T>&) const;
+	bool operator==(const PlanificadorRR<T, Hash, Asignador, Estadisticas>&) const;
+	size_t huella() const;
 	ostream& mostrarPlanificadorRR(ostream&) const;
+	ostream& mostrarPlanificadorRR(ostream&, int, int) const;
+	char* mostrarEn(char*, char*, int = 0, int = INT_MAX) const;
+	const string& mostrado() const;
+	// Definidos en InstantaneaPlanificador.h, que hay que incluir para usarlos
+	bool guardar(const char*) const;
+	bool cargar(const char*);
+	void reubicarEnOrden();
+	using Estadisticas::estadisticas;
 
   private:
   
-	PlanificadorRR<T>& operator=(const PlanificadorRR<T>& otra) {
+	PlanificadorRR<T, Hash, Asignador, Estadisticas>& operator=(const PlanificadorRR<T, Hash, Asignador, Estadisticas>& otra) {
 		assert(false);
 		return *this;
 	}
 
+	/**
+	 * siguiente y anterior enlazan a todos los procesos en orden de ejecución.
+	 * siguienteEnEstado y anteriorEnEstado enlazan al nodo en el anillo de
+	 * los activos (en orden de ejecución) o en el de los pausados (sin orden),
+	 * según corresponda. Un nodo muerto ya no está en ningún anillo y
+	 * siguienteEnEstado lo enlaza en la lista de los que esperan a compactar.
+	 * posicion lo ubica en el árbol de posiciones de la representación.
+	 */
 	struct Nodo {
 		T pid;
 		bool pausado;
+		bool muerto;
 		Nodo* siguiente;
 		Nodo* anterior;
-		Nodo(const T& p): pid(p), pausado(false), siguiente(NULL), anterior(NULL){}
+		Nodo* siguienteEnEstado;
+		Nodo* anteriorEnEstado;
+		EnlacesDePosicion<Nodo> posicion;
+		template<typename... Argumentos>
+		explicit Nodo(Argumentos&&... argumentos): pid(std::forward<Argumentos>(argumentos)...),
+			pausado(false), muerto(false), siguiente(NULL), anterior(NULL),
+			siguienteEnEstado(NULL), anteriorEnEstado(NULL){}
+	};
+
+	typedef typename allocator_traits<Asignador>::template rebind_alloc<Nodo> AsignadorDeNodos;
+	typedef allocator_traits<AsignadorDeNodos> RasgosDeAsignador;
+
+	/**
+	 * Iterador de sólo lectura que da una vuelta al anillo a partir del
+	 * actual, siguiendo el enlace Siguiente: con siguiente pasa por todos
+	 * los procesos; con siguienteEnEstado, sólo por los activos, sin pasar
+	 * por los pausados. No copia ni pide memoria. Cualquier modificación
+	 * del planificador lo invalida.
+	 */
+	template<Nodo* Nodo::*Siguiente>
+	class IteradorDeProcesos {
+
+	  public:
+
+		typedef forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef const T& reference;
+
+		IteradorDeProcesos(): nodo(NULL), restantes(0) {}
+
+		reference operator*() const { return nodo->pid; }
+		pointer operator->() const { return &nodo->pid; }
+		bool pausado() const { return nodo->pausado; }
+
+		IteradorDeProcesos& operator++() {
+			nodo = nodo->*Siguiente;
+			restantes--;
+			return *this;
+		}
+
+		IteradorDeProcesos operator++(int) {
+			IteradorDeProcesos anterior = *this;
+			++*this;
+			return anterior;
+		}
+
+		// Como el anillo no tiene fin, los iteradores se distinguen por
+		// cuántos procesos les quedan por recorrer
+		bool operator==(const IteradorDeProcesos& otro) const { return restantes == otro.restantes; }
+		bool operator!=(const IteradorDeProcesos& otro) const { return restantes != otro.restantes; }
+
+	  private:
+
+		friend class PlanificadorRR;
+
+		IteradorDeProcesos(const Nodo* nodo, int restantes): nodo(nodo), restantes(restantes) {}
+
+		const Nodo* nodo;
+		int restantes;
 	};
 
-	Nodo* dameProceso(const T&);
-	int cantidadProcesosActivos() const;
+  public:
+
+	typedef IteradorDeProcesos<&Nodo::siguiente> const_iterator;
+	typedef IteradorDeProcesos<&Nodo::siguienteEnEstado> IteradorDeActivos;
+
+	/**
+	 * Los procesos activos en orden de ejecución, desde el actual, para
+	 * recorrer con range-for o con los algoritmos estándar.
+	 */
+	class VistaDeActivos {
+
+	  public:
+
+		IteradorDeActivos begin() const { return primero; }
+		IteradorDeActivos end() const { return IteradorDeActivos(); }
+		int size() const { return cantidad; }
+		bool empty() const { return cantidad == 0; }
+
+	  private:
 
+		friend class PlanificadorRR;
+
+		VistaDeActivos(IteradorDeActivos primero, int cantidad): primero(primero), cantidad(cantidad) {}
+
+		IteradorDeActivos primero;
+		int cantidad;
+	};
+
+	const_iterator begin() const;
+	const_iterator end() const;
+	VistaDeActivos procesosActivos() const;
+
+  private:
+
+	/**
+	 * Estado compartido entre copias. Cada copia sólo guarda su proceso
+	 * actual y si está detenida; el resto se comparte hasta que una copia
+	 * lo modifica y se queda con una representación propia.
+	 */
+	struct Representacion {
+		Nodo* pausados;
+		int cantidadProcesos;
+		int cantidadActivos;
+		// Suma de la huella de cada par (proceso, siguiente) y de cada
+		// proceso pausado; no depende de dónde empieza el recorrido.
+		uint64_t huellaAristas;
+		uint64_t huellaPausados;
+		// Eliminados con eliminarProcesoDiferido que todavía ocupan memoria
+		// y su entrada en el índice (ver compactar)
+		Nodo* muertos;
+		int cantidadMuertos;
+		IndiceDeProcesos<T, Nodo*, Hash> indice;
+		// Los procesos en orden de ejecución (empezando por cualquiera), para
+		// ir a una posición sin recorrer el anillo
+		ArbolDePosiciones<Nodo> posiciones;
+		AsignadorDeNodos asignador;
+		atomic<int> referencias;
+		explicit Representacion(const AsignadorDeNodos& a): pausados(NULL),
+			cantidadProcesos(0), cantidadActivos(0), huellaAristas(0), huellaPausados(0),
+			muertos(NULL), cantidadMuertos(0), asignador(a), referencias(1){}
+	};
+
+	typedef HuellaDeProcesos<T, Hash> Huella;
+	typedef MedicionDeOperacion<Estadisticas> Medicion;
+
+	// Lo más que ocupa un proceso entero mostrado, con su separador
+	static const int LARGO_MAXIMO_DE_ENTRADA = 48;
+
+	/**
+	 * Texto guardado por mostrado(). Vale mientras la versión y el proceso
+	 * actual del planificador sean los mismos que cuando se generó.
+	 */
+	struct Mostrado {
+		string texto;
+		uint64_t version;
+		const Nodo* actual;
+	};
+
+	const Estadisticas& contadores() const { return *this; }
+
+	template<typename... Argumentos>
+	Nodo* crearNodo(Argumentos&&...);
+	void destruirNodo(Nodo*);
+	void enlazarNuevo(Nodo*);
+	void eliminarNodo(Nodo*);
+	void desenlazarNodo(Nodo*);
+	void pausarNodo(Nodo*);
+	void reanudarNodo(Nodo*, Nodo*);
+	void separar();
+	AsignadorDeNodos asignadorPropio() const;
+	void soltar(Representacion*, Nodo*);
+	static Representacion* representacionVacia() noexcept;
+	static uint64_t huellaArista(const Nodo*, const Nodo*);
+	Nodo* dameProceso(const T&) const;
+	Nodo* anteriorActivo(Nodo*) const;
+	static void enlazarEnEstado(Nodo*&, Nodo*);
+	static void desenlazarDeEstado(Nodo*&, Nodo*);
+	const Nodo* nodoEnPosicion(int) const;
+	int entradasDePagina(int, int) const;
+	char* escribirEntrada(char*, const Nodo*) const;
+	ostream& mostrarPagina(ostream&, int, int, true_type) const;
+	ostream& mostrarPagina(ostream&, int, int, false_type) const;
+	void generarMostrado(string&, true_type) const;
+	void generarMostrado(string&, false_type) const;
+
+	// Si hay procesos activos, procesoActual es uno de ellos y es la
+	// entrada al anillo de activos.
+	Representacion* rep;
 	Nodo* procesoActual;
-	int cantidadProcesos;
 	bool planificadorDetenido;
+	// Aumenta con cada modificación de esta copia (ver separar)
+	uint64_t version;
+	mutable Mostrado* mostradoEnCache;
 };
 
 /**
  * Crea un nuevo planificador de tipo Round Robin.
  */	
-template<class T>
-PlanificadorRR<T>::PlanificadorRR(){
+template<class T, class Hash, class Asignador, class Estadisticas>
+PlanificadorRR<T, Hash, Asignador, Estadisticas>::PlanificadorRR(){
+	rep = representacionVacia();
+	procesoActual = NULL;
+	planificadorDetenido = false;
+	version = 0;
+	mostradoEnCache = NULL;
+}
+
+/**
+ * Crea un nuevo planificador cuyos nodos salen del asignador dado.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+PlanificadorRR<T, Hash, Asignador, Estadisticas>::PlanificadorRR(const Asignador& a){
+	rep = new Representacion(AsignadorDeNodos(a));
+	procesoActual = NULL;
+	planificadorDetenido = false;
+	version = 0;
+	mostradoEnCache = NULL;
+}
+
+/**
+ * Crea un planificador con los procesos del rango, agregados en ese
+ * orden (ver agregarProcesos).
+ * PRE: Los procesos del rango son distintos entre sí.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+template<typename Iterador>
+PlanificadorRR<T, Hash, Asignador, Estadisticas>::PlanificadorRR(Iterador desde, Iterador hasta){
+	rep = new Representacion(AsignadorDeNodos());
+	procesoActual = NULL;
+	planificadorDetenido = false;
+	version = 0;
+	mostradoEnCache = NULL;
+	agregarProcesos(desde, hasta);
+}
+
+/**
+ * Crea un planificador con los procesos de la lista, agregados en ese
+ * orden (ver agregarProcesos).
+ * PRE: Los procesos de la lista son distintos entre sí.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+PlanificadorRR<T, Hash, Asignador, Estadisticas>::PlanificadorRR(initializer_list<T> procesos){
+	rep = new Representacion(AsignadorDeNodos());
 	procesoActual = NULL;
-	cantidadProcesos = 0;
 	planificadorDetenido = false;
+	version = 0;
+	mostradoEnCache = NULL;
+	agregarProcesos(procesos.begin(), procesos.end());
 }
 
 /**
  * Una vez copiado, ambos planificadores deben ser independientes, 
  * es decir, por ejemplo, que cuando se borra un proceso en uno
  * no debe borrarse en el otro.
+ *
+ * La copia cuesta O(1): comparte los nodos con el original hasta que
+ * alguno de los dos los modifica, y ese paga entonces la copia (ver separar).
  */	
-template<class T>
-PlanificadorRR<T>::PlanificadorRR(const PlanificadorRR<T>& p){
-	if(p.cantidadDeProcesos() == 0){
-		procesoActual = NULL;
-		cantidadProcesos = 0;
-		planificadorDetenido = false;
-	}else{
-		cantidadProcesos = p.cantidadDeProcesos();
-		planificadorDetenido = p.detenido();
-		T pid = p.procesoEjecutado();
-		procesoActual = new Nodo(pid);
-		procesoActual->pausado = !p.estaActivo(pid);
-		procesoActual->siguiente = procesoActual;
-		procesoActual->anterior = procesoActual;
-		int i;
-		Nodo* actual = procesoActual;
-		Nodo* copia = p.procesoActual;
-		for(i=1; i<cantidadProcesos; i++){
-			copia = copia->siguiente;
-			Nodo* siguiente = new Nodo(copia->pid);
-			siguiente->pausado = copia->pausado;
-			siguiente->anterior = actual;
-			actual->siguiente = siguiente;
-			actual = siguiente;
-		}
-		actual->siguiente = procesoActual;
-		procesoActual->anterior = actual;
+template<class T, class Hash, class Asignador, class Estadisticas>
+PlanificadorRR<T, Hash, Asignador, Estadisticas>::PlanificadorRR(const PlanificadorRR<T, Hash, Asignador, Estadisticas>& p): Estadisticas(){
+	Medicion medicion(p.contadores(), OP_COPIAR);
+	rep = p.rep;
+	rep->referencias++;
+	procesoActual = p.procesoActual;
+	planificadorDetenido = p.planificadorDetenido;
+	version = 0;
+	mostradoEnCache = NULL;
+}
+
+/**
+ * Se lleva los nodos de p sin copiarlos. p queda vacío y sin detener.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+PlanificadorRR<T, Hash, Asignador, Estadisticas>::PlanificadorRR(PlanificadorRR<T, Hash, Asignador, Estadisticas>&& p) noexcept: Estadisticas(){
+	rep = p.rep;
+	procesoActual = p.procesoActual;
+	planificadorDetenido = p.planificadorDetenido;
+	version = 0;
+	mostradoEnCache = NULL;
+	p.rep = representacionVacia();
+	p.procesoActual = NULL;
+	p.planificadorDetenido = false;
+	p.version++;
+}
+
+/**
+ * Suelta los nodos propios y se lleva los de p sin copiarlos. p queda
+ * vacío y sin detener.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+PlanificadorRR<T, Hash, Asignador, Estadisticas>& PlanificadorRR<T, Hash, Asignador, Estadisticas>::operator=(PlanificadorRR<T, Hash, Asignador, Estadisticas>&& p) noexcept{
+	if(this != &p){
+		soltar(rep, procesoActual);
+		rep = p.rep;
+		procesoActual = p.procesoActual;
+		planificadorDetenido = p.planificadorDetenido;
+		version++;
+		p.rep = representacionVacia();
+		p.procesoActual = NULL;
+		p.planificadorDetenido = false;
+		p.version++;
 	}
+	return *this;
 }
 
 /**
- * Acordarse de liberar toda la memoria!
+ * Libera todos los nodos en una sola pasada por el anillo, si nadie
+ * más los comparte.
  */	 
-template<class T>
-PlanificadorRR<T>::~PlanificadorRR(){
-	int i;
-	Nodo* borrador = procesoActual;
-	for(i = 0; i < cantidadProcesos; i++){
-		Nodo* siguiente = borrador->siguiente;
-		eliminarProceso(borrador->pid);
-		borrador = siguiente;
-	}
+template<class T, class Hash, class Asignador, class Estadisticas>
+PlanificadorRR<T, Hash, Asignador, Estadisticas>::~PlanificadorRR(){
+	soltar(rep, procesoActual);
+	delete mostradoEnCache;
 }
 
 /**
@@ -124,25 +534,138 @@ PlanificadorRR<T>::~PlanificadorRR(){
  * la posición es arbitraria y el proceso pasa a ser ejecutado automáticamente.
  * PRE: El proceso no está siendo planificado por el planificador.
  */
-template<class T>
-void PlanificadorRR<T>::agregarProceso(const T& pid){
-	assert(!esPlanificado(pid));
-	Nodo* nuevoProceso = new Nodo(pid);
-	if (cantidadProcesos == 0) {
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::agregarProceso(const T& pid){
+	Medicion medicion(contadores(), OP_AGREGAR);
+	separar();
+	assert(dameProceso(pid) == NULL);
+	enlazarNuevo(crearNodo(pid));
+}
+
+/**
+ * Como agregarProceso, pero mueve el pid al nodo en lugar de copiarlo.
+ * PRE: El proceso no está siendo planificado por el planificador.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::agregarProceso(T&& pid){
+	Medicion medicion(contadores(), OP_AGREGAR);
+	separar();
+	assert(dameProceso(pid) == NULL);
+	enlazarNuevo(crearNodo(std::move(pid)));
+}
+
+/**
+ * Como agregarProceso, pero construye el pid directamente en el nodo
+ * a partir de los argumentos, sin copias intermedias.
+ * PRE: El proceso construido no está siendo planificado por el planificador.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+template<typename... Argumentos>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::emplaceProceso(Argumentos&&... argumentos){
+	Medicion medicion(contadores(), OP_AGREGAR);
+	separar();
+	Nodo* nuevo = crearNodo(std::forward<Argumentos>(argumentos)...);
+	assert(dameProceso(nuevo->pid) == NULL);
+	enlazarNuevo(nuevo);
+}
+
+/**
+ * Agrega los procesos del rango, con el mismo resultado que llamar a
+ * agregarProceso con cada uno en orden. El índice se agranda una sola
+ * vez y, si el asignador permite liberar por partes, los nodos se piden
+ * en un único bloque. Cada proceso se controla contra el índice, que ya
+ * incluye a los anteriores del rango, así que los repetidos se detectan
+ * en la misma pasada.
+ * PRE: Los iteradores son al menos de avance (forward).
+ * PRE: Ningún proceso del rango está planificado ni aparece dos veces.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+template<typename Iterador>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::agregarProcesos(Iterador desde, Iterador hasta){
+	Medicion medicion(contadores(), OP_AGREGAR);
+	separar();
+	size_t n = distance(desde, hasta);
+	if(n == 0){
+		return;
+	}
+	rep->indice.reservar(rep->cantidadProcesos + n);
+	bool enBloque = LiberaPorPartes<AsignadorDeNodos>::valor;
+	Nodo* bloque = NULL;
+	if(enBloque){
+		bloque = RasgosDeAsignador::allocate(rep->asignador, n);
+		contadores().contarAsignaciones(n);
+	}
+	for(size_t i = 0; desde != hasta; ++desde, i++){
+		assert(dameProceso(*desde) == NULL);
+		Nodo* nuevo;
+		if(enBloque){
+			nuevo = bloque + i;
+			RasgosDeAsignador::construct(rep->asignador, nuevo, *desde);
+		}else{
+			nuevo = crearNodo(*desde);
+		}
+		enlazarNuevo(nuevo);
+	}
+}
+
+/**
+ * Pasa todos los procesos de otro planificador a este, con el mismo
+ * resultado que agregarlos uno por uno en el orden de ejecución del otro
+ * (empezando por su proceso actual) y pausar los que estaban pausados.
+ * El otro queda vacío.
+ * PRE: Ningún proceso del otro está planificado en este.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::absorber(PlanificadorRR<T, Hash, Asignador, Estadisticas>& otro){
+	Medicion medicion(contadores(), OP_AGREGAR);
+	assert(&otro != this);
+	if(otro.rep->cantidadProcesos == 0){
+		return;
+	}
+	separar();
+	rep->indice.reservar(rep->cantidadProcesos + otro.rep->cantidadProcesos);
+	Nodo* actual = otro.procesoActual;
+	for(int i = 0; i < otro.rep->cantidadProcesos; i++, actual = actual->siguiente){
+		assert(dameProceso(actual->pid) == NULL);
+		Nodo* nuevo = crearNodo(actual->pid);
+		enlazarNuevo(nuevo);
+		if(actual->pausado){
+			pausarNodo(nuevo);
+		}
+	}
+	otro.vaciar();
+}
+
+/**
+ * Enlaza un nodo recién creado inmediatamente antes del actual, como
+ * proceso activo, y lo indexa.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::enlazarNuevo(Nodo* nuevoProceso){
+	rep->indice.insertar(nuevoProceso->pid, nuevoProceso);
+	rep->posiciones.insertarAntesDe(nuevoProceso, procesoActual);
+	if (rep->cantidadProcesos == 0) {
 		procesoActual = nuevoProceso;
 		procesoActual->siguiente = procesoActual;
 		procesoActual->anterior = procesoActual;
+		rep->huellaAristas += huellaArista(nuevoProceso, nuevoProceso);
 	} else {
 		Nodo* ultimo = procesoActual->anterior;
+		rep->huellaAristas += huellaArista(ultimo, nuevoProceso) + huellaArista(nuevoProceso, procesoActual)
+			- huellaArista(ultimo, procesoActual);
 		procesoActual->anterior = nuevoProceso;
 		nuevoProceso->anterior = ultimo;
 		ultimo->siguiente = nuevoProceso;
 		nuevoProceso->siguiente = procesoActual;
 	}
-	if(cantidadDeProcesosActivos() == 0){
+	if(rep->cantidadActivos == 0){
 		procesoActual = nuevoProceso;
 	}
-	cantidadProcesos++;
+	// Queda inmediatamente antes del actual también entre los activos
+	Nodo* activos = rep->cantidadActivos == 0 ? NULL : procesoActual;
+	enlazarEnEstado(activos, nuevoProceso);
+	rep->cantidadActivos++;
+	rep->cantidadProcesos++;
 }
 
 /**
@@ -151,42 +674,150 @@ void PlanificadorRR<T>::agregarProceso(const T& pid){
  * el siguiente (si es que existe).
  * PRE: El proceso está siendo planificado por el planificador.
  */
-template<class T>
-void PlanificadorRR<T>::eliminarProceso(const T& p){
-	assert(esPlanificado(p));
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::eliminarProceso(const T& p){
+	Medicion medicion(contadores(), OP_ELIMINAR);
+	separar();
 	Nodo* aEliminar = dameProceso(p);
-	cout << "Nodo a eliminar: " << aEliminar->pid << endl;
-	if (cantidadProcesos > 1) {
-		//Reorganizo relaciones;
-		if(cantidadProcesos <= 2){
-			aEliminar->siguiente->siguiente = aEliminar->siguiente;
-			aEliminar->siguiente->anterior = aEliminar->siguiente;
-		}else{
-			Nodo* anterior = aEliminar->anterior;
-			Nodo* siguiente = aEliminar->siguiente;
-			anterior->siguiente = aEliminar->siguiente;
-			siguiente->anterior = aEliminar->anterior;	
+	assert(aEliminar != NULL);
+	eliminarNodo(aEliminar);
+}
+
+/**
+ * Elimina los procesos del rango, con el mismo resultado que llamar a
+ * eliminarProceso con cada uno en orden.
+ * PRE: Todos los procesos del rango están planificados y no se repiten.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+template<typename Iterador>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::eliminarProcesos(Iterador desde, Iterador hasta){
+	Medicion medicion(contadores(), OP_ELIMINAR);
+	separar();
+	for(; desde != hasta; ++desde){
+		Nodo* aEliminar = dameProceso(*desde);
+		assert(aEliminar != NULL);
+		eliminarNodo(aEliminar);
+	}
+}
+
+/**
+ * Elimina todos los procesos. No cambia si el planificador está detenido.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::vaciar(){
+	Medicion medicion(contadores(), OP_VACIAR);
+	AsignadorDeNodos asignador = asignadorPropio();
+	soltar(rep, procesoActual);
+	rep = new Representacion(asignador);
+	procesoActual = NULL;
+	version++;
+}
+
+/**
+ * Elimina un proceso con el mismo resultado que eliminarProceso, pero sin
+ * liberar su nodo ni sacarlo del índice: sólo lo saca de los anillos y
+ * del árbol de posiciones, en O(log n), y lo deja para compactar. Sirve para eliminar muchos procesos de
+ * golpe sin que cada uno pague la liberación.
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::eliminarProcesoDiferido(const T& p){
+	Medicion medicion(contadores(), OP_ELIMINAR);
+	separar();
+	Nodo* aEliminar = dameProceso(p);
+	assert(aEliminar != NULL);
+	desenlazarNodo(aEliminar);
+	aEliminar->muerto = true;
+	aEliminar->siguienteEnEstado = rep->muertos;
+	rep->muertos = aEliminar;
+	rep->cantidadMuertos++;
+}
+
+/**
+ * Libera hasta maximo de los nodos eliminados con eliminarProcesoDiferido
+ * y devuelve cuántos liberó. Llamándola con un máximo chico cada tanto
+ * (por ejemplo, entre ejecuciones) el costo de una ráfaga de eliminaciones
+ * se reparte en el tiempo. No cambia el estado observable del planificador;
+ * si la representación está compartida con otra copia no libera nada, y
+ * los nodos se liberan cuando se separen o se suelten.
+ * PRE: maximo >= 0
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+int PlanificadorRR<T, Hash, Asignador, Estadisticas>::compactar(int maximo){
+	Medicion medicion(contadores(), OP_ELIMINAR);
+	assert(maximo >= 0);
+	if(rep->referencias > 1){
+		return 0;
+	}
+	int liberados = 0;
+	while(liberados < maximo && rep->muertos != NULL){
+		Nodo* muerto = rep->muertos;
+		rep->muertos = muerto->siguienteEnEstado;
+		// El pid puede haberse vuelto a agregar mientras esperaba
+		if(rep->indice.buscar(muerto->pid, NULL) == muerto){
+			rep->indice.borrar(muerto->pid);
 		}
-		if(aEliminar->pid == procesoActual->pid){
-			//Pasa al que sigue
-
-			procesoActual = procesoActual->siguiente;
-			int i = 1;
-			if(cantidadProcesos > 2){
-				while(i < cantidadProcesos && procesoActual->pausado){
-					procesoActual = procesoActual->siguiente;	
-				}
-			}
+		destruirNodo(muerto);
+		liberados++;
+	}
+	rep->cantidadMuertos -= liberados;
+	return liberados;
+}
+
+/**
+ * Cuántos procesos eliminados con eliminarProcesoDiferido falta liberar.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+int PlanificadorRR<T, Hash, Asignador, Estadisticas>::cantidadDeProcesosPorCompactar() const{
+	return rep->cantidadMuertos;
+}
+
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::eliminarNodo(Nodo* aEliminar){
+	desenlazarNodo(aEliminar);
+	rep->indice.borrar(aEliminar->pid);
+	destruirNodo(aEliminar);
+}
+
+/**
+ * Saca un nodo de los anillos y lo descuenta, sin liberarlo. Si era el
+ * actual, pasa a ejecutarse el siguiente activo (si es que existe).
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::desenlazarNodo(Nodo* aEliminar){
+	if(aEliminar->pausado){
+		desenlazarDeEstado(rep->pausados, aEliminar);
+	}else{
+		Nodo* activos = procesoActual;
+		desenlazarDeEstado(activos, aEliminar);
+		rep->cantidadActivos--;
+		if(aEliminar == procesoActual && activos != NULL){
+			//Pasa al siguiente activo
+			procesoActual = activos;
 		}
 	}
-	delete aEliminar;
-	cantidadProcesos--;
+	if(aEliminar == procesoActual){
+		procesoActual = rep->cantidadProcesos > 1 ? aEliminar->siguiente : NULL;
+	}
+	if(aEliminar->pausado){
+		rep->huellaPausados -= Huella::de(aEliminar->pid);
+	}
+	if(rep->cantidadProcesos == 1){
+		rep->huellaAristas -= huellaArista(aEliminar, aEliminar);
+	}else{
+		rep->huellaAristas += huellaArista(aEliminar->anterior, aEliminar->siguiente)
+			- huellaArista(aEliminar->anterior, aEliminar) - huellaArista(aEliminar, aEliminar->siguiente);
+	}
+	aEliminar->anterior->siguiente = aEliminar->siguiente;
+	aEliminar->siguiente->anterior = aEliminar->anterior;
+	rep->posiciones.borrar(aEliminar);
+	rep->cantidadProcesos--;
 }
-/**template<class T>
-void PlanificadorRR<T>::eliminarProceso(const T& p){
+/**template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::eliminarProceso(const T& p){
 	assert(esPlanificado(p));
 	Nodo* aEliminar = dameProceso(p);
-	if(cantidadProcesos > 1){
+	if(rep->cantidadProcesos > 1){
 		
 	}
 }*/
@@ -195,9 +826,9 @@ void PlanificadorRR<T>::eliminarProceso(const T& p){
  * Devuelve el proceso que está actualmente en ejecución.
  * PRE: Hay al menos un proceso activo en el planificador.
  */
-template<class T>
-const T& PlanificadorRR<T>::procesoEjecutado() const{
-	assert(cantidadProcesos > 0);
+template<class T, class Hash, class Asignador, class Estadisticas>
+const T& PlanificadorRR<T, Hash, Asignador, Estadisticas>::procesoEjecutado() const{
+	assert(rep->cantidadProcesos > 0);
 	return procesoActual->pid;
 }
 
@@ -206,12 +837,93 @@ const T& PlanificadorRR<T>::procesoEjecutado() const{
  * respetando el orden de planificación.
  * PRE: Hay al menos un proceso activo en el planificador.
  */
-template<class T>
-void PlanificadorRR<T>::ejecutarSiguienteProceso(){
-	assert(cantidadDeProcesosActivos() > 0);
-	procesoActual = procesoActual->siguiente;
-	while(procesoActual->pausado){
-		procesoActual = procesoActual->siguiente;	
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::ejecutarSiguienteProceso(){
+	Medicion medicion(contadores(), OP_EJECUTAR);
+	assert(rep->cantidadActivos > 0);
+	procesoActual = procesoActual->siguienteEnEstado;
+}
+
+/**
+ * Avanza k procesos activos, con el mismo resultado que llamar k veces a
+ * ejecutarSiguienteProceso. Como el anillo de activos es circular basta
+ * con k módulo la cantidad de activos: el árbol de posiciones da la
+ * posición del actual entre los activos y el activo que está k módulo n
+ * más adelante, en O(log n) sin importar k ni cuántos haya pausados.
+ * PRE: k >= 0
+ * PRE: Hay al menos un proceso activo en el planificador.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::ejecutarSiguientes(long k){
+	Medicion medicion(contadores(), OP_EJECUTAR);
+	assert(k >= 0);
+	assert(rep->cantidadActivos > 0);
+	long activos = rep->cantidadActivos;
+	long pasos = k % activos;
+	if(pasos == 0){
+		return;
+	}
+	long destino = (rep->posiciones.posicionEntreActivos(procesoActual) + pasos) % activos;
+	procesoActual = rep->posiciones.activoEnPosicion((int)destino);
+}
+
+/**
+ * Escribe en salida los próximos k procesos en ejecutarse, empezando por
+ * el actual; si k supera la cantidad de activos, se repiten en el mismo
+ * orden. No pide memoria ni modifica el planificador. Devuelve la salida
+ * avanzada, como copy.
+ * PRE: k == 0 o hay al menos un proceso activo en el planificador.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+template<typename Salida>
+Salida PlanificadorRR<T, Hash, Asignador, Estadisticas>::proximosProcesos(int k, Salida salida) const{
+	assert(k == 0 || rep->cantidadActivos > 0);
+	contadores().contarSaltos(k);
+	const Nodo* actual = procesoActual;
+	for(int i = 0; i < k; i++){
+		*salida = actual->pid;
+		++salida;
+		actual = actual->siguienteEnEstado;
+	}
+	return salida;
+}
+
+/**
+ * Recorre todos los procesos en orden de ejecución, empezando por el
+ * actual, en una sola vuelta al anillo.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+typename PlanificadorRR<T, Hash, Asignador, Estadisticas>::const_iterator PlanificadorRR<T, Hash, Asignador, Estadisticas>::begin() const{
+	return const_iterator(procesoActual, rep->cantidadProcesos);
+}
+
+template<class T, class Hash, class Asignador, class Estadisticas>
+typename PlanificadorRR<T, Hash, Asignador, Estadisticas>::const_iterator PlanificadorRR<T, Hash, Asignador, Estadisticas>::end() const{
+	return const_iterator();
+}
+
+/**
+ * Devuelve una vista de sólo los procesos activos, en orden de ejecución
+ * a partir del actual. Avanzar cuesta O(1) aunque haya muchos pausados
+ * seguidos, porque recorre el anillo de los activos.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+typename PlanificadorRR<T, Hash, Asignador, Estadisticas>::VistaDeActivos PlanificadorRR<T, Hash, Asignador, Estadisticas>::procesosActivos() const{
+	return VistaDeActivos(IteradorDeActivos(procesoActual, rep->cantidadActivos), rep->cantidadActivos);
+}
+
+/**
+ * Llama a funcion(pid, pausado) con cada proceso, pausados incluidos, en
+ * orden de ejecución a partir del actual. No modifica el planificador.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+template<typename Funcion>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::recorrerProcesos(Funcion funcion) const{
+	contadores().contarSaltos(rep->cantidadProcesos);
+	const Nodo* actual = procesoActual;
+	for(int i = 0; i < rep->cantidadProcesos; i++){
+		funcion(actual->pid, actual->pausado);
+		actual = actual->siguiente;
 	}
 }
 
@@ -223,19 +935,49 @@ void PlanificadorRR<T>::ejecutarSiguienteProceso(){
  * PRE: El proceso está siendo planificado por el planificador.
  * PRE: El proceso está activo.
  */
-template<class T>
-void PlanificadorRR<T>::pausarProceso(const T& p){
-	assert(esPlanificado(p));
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::pausarProceso(const T& p){
+	Medicion medicion(contadores(), OP_PAUSAR);
+	separar();
 	Nodo* proceso = dameProceso(p);
-	if(proceso == procesoActual && cantidadDeProcesosActivos() > 0){
-		procesoActual = procesoActual->siguiente;
-		while(procesoActual->pausado){
-			procesoActual = procesoActual->siguiente;
+	assert(proceso != NULL && !proceso->pausado);
+	pausarNodo(proceso);
+}
+
+/**
+ * Pausa todos los procesos activos que cumplen el predicado, recorriendo
+ * una sola vez el anillo de activos. El resultado es el mismo que pausarlos
+ * de a uno en orden de ejecución a partir del actual.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+template<typename Predicado>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::pausarSi(Predicado predicado){
+	Medicion medicion(contadores(), OP_PAUSAR);
+	separar();
+	int activos = rep->cantidadActivos;
+	contadores().contarSaltos(activos);
+	Nodo* actual = procesoActual;
+	for(int i = 0; i < activos; i++){
+		Nodo* siguiente = actual->siguienteEnEstado;
+		if(predicado(actual->pid)){
+			pausarNodo(actual);
 		}
+		actual = siguiente;
+	}
+}
+
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::pausarNodo(Nodo* proceso){
+	Nodo* activos = procesoActual;
+	desenlazarDeEstado(activos, proceso);
+	if(proceso == procesoActual && activos != NULL){
+		procesoActual = activos;
 	}
-	assert(!proceso->pausado);
-	// Nodo* procesoAPausar = &proceso;
+	enlazarEnEstado(rep->pausados, proceso);
 	proceso->pausado = true;
+	rep->posiciones.actualizarEstado(proceso);
+	rep->huellaPausados += Huella::de(proceso->pid);
+	rep->cantidadActivos--;
 }
 
 /**
@@ -245,11 +987,66 @@ void PlanificadorRR<T>::pausarProceso(const T& p){
  * PRE: El proceso está siendo planificado por el planificador.
  * PRE: El proceso está inactivo.
  */
-template<class T>
-void PlanificadorRR<T>::reanudarProceso(const T&p){
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::reanudarProceso(const T&p){
+	Medicion medicion(contadores(), OP_REANUDAR);
+	separar();
 	Nodo* proceso = dameProceso(p);
-	assert(esPlanificado(p) && proceso->pausado);
+	assert(proceso != NULL && proceso->pausado);
+	reanudarNodo(proceso, NULL);
+}
+
+/**
+ * Reanuda todos los procesos pausados que cumplen el predicado, en una
+ * sola pasada por el orden de ejecución: el último activo visto es el
+ * lugar donde entra cada reanudado, así que no hace falta buscarlo.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+template<typename Predicado>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::reanudarSi(Predicado predicado){
+	Medicion medicion(contadores(), OP_REANUDAR);
+	separar();
+	int total = rep->cantidadProcesos;
+	contadores().contarSaltos(total);
+	Nodo* actual = procesoActual;
+	Nodo* ultimoActivo = NULL;
+	for(int i = 0; i < total; i++){
+		Nodo* siguiente = actual->siguiente;
+		if(actual->pausado && predicado(actual->pid)){
+			reanudarNodo(actual, ultimoActivo);
+		}
+		if(!actual->pausado){
+			ultimoActivo = actual;
+		}
+		actual = siguiente;
+	}
+}
+
+/**
+ * Reanuda un nodo pausado. anterior es el activo que lo precede en el orden
+ * de ejecución, o NULL para buscarlo.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::reanudarNodo(Nodo* proceso, Nodo* anterior){
+	desenlazarDeEstado(rep->pausados, proceso);
 	proceso->pausado = false;
+	rep->posiciones.actualizarEstado(proceso);
+	rep->huellaPausados -= Huella::de(proceso->pid);
+	if(rep->cantidadActivos == 0){
+		procesoActual = proceso;
+		proceso->siguienteEnEstado = proceso;
+		proceso->anteriorEnEstado = proceso;
+	}else{
+		// Entra al anillo de activos en la misma posición que tenía
+		if(anterior == NULL){
+			anterior = anteriorActivo(proceso);
+		}
+		proceso->anteriorEnEstado = anterior;
+		proceso->siguienteEnEstado = anterior->siguienteEnEstado;
+		anterior->siguienteEnEstado->anteriorEnEstado = proceso;
+		anterior->siguienteEnEstado = proceso;
+	}
+	rep->cantidadActivos++;
 }
 
 /**
@@ -257,8 +1054,8 @@ void PlanificadorRR<T>::reanudarProceso(const T&p){
  * para atender una interrupción del sistema.
  * PRE: El planificador no está detenido.
  */
-template<class T>
-void PlanificadorRR<T>::detener(){
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::detener(){
 	assert(!planificadorDetenido);
 	planificadorDetenido = true;
 }
@@ -268,8 +1065,8 @@ void PlanificadorRR<T>::detener(){
  * luego de atender una interrupción del sistema.
  * PRE: El planificador está detenido.
  */
-template<class T>
-void PlanificadorRR<T>::reanudar(){
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::reanudar(){
 	assert(planificadorDetenido);
 	planificadorDetenido = false;
 }
@@ -277,120 +1074,115 @@ void PlanificadorRR<T>::reanudar(){
 /**
  * Informa si el planificador está detenido por el sistema operativo.
  */
-template<class T>
-bool PlanificadorRR<T>::detenido() const{
+template<class T, class Hash, class Asignador, class Estadisticas>
+bool PlanificadorRR<T, Hash, Asignador, Estadisticas>::detenido() const{
 	return planificadorDetenido;
 }
 
 /**
  * Informa si un cierto proceso está siendo planificado por el planificador.
  */
-template<class T>
-bool PlanificadorRR<T>::esPlanificado(const T& p) const{
-	if(cantidadProcesos > 0){
-		int i;
-		Nodo* actual = procesoActual;
-		for (i=0; i < cantidadProcesos; i++) {
-			if (actual->pid == p) {
-				return true;
-			} else {
-				actual = actual->siguiente;
-			}
-		}
-		return false;
-	}else{
-		return false;
-	}
+template<class T, class Hash, class Asignador, class Estadisticas>
+bool PlanificadorRR<T, Hash, Asignador, Estadisticas>::esPlanificado(const T& p) const{
+	Medicion medicion(contadores(), OP_BUSCAR);
+	return dameProceso(p) != NULL;
 }
 
 /**
  * Informa si un cierto proceso está activo en el planificador.
  * PRE: El proceso está siendo planificado por el planificador.
  */
-template<class T>
-bool PlanificadorRR<T>::estaActivo(const T& p) const{
-	assert(esPlanificado(p));
-	int i;
-	Nodo* actual = procesoActual;
-	for (i = 0; i < cantidadProcesos; i++) {
-		if (actual->pid == p) {
-			return !(actual->pausado);
-		}
-		actual = actual->siguiente;
-	}
-	// Nodo* procesoActivo = &proceso;
-	return false;
+template<class T, class Hash, class Asignador, class Estadisticas>
+bool PlanificadorRR<T, Hash, Asignador, Estadisticas>::estaActivo(const T& p) const{
+	Medicion medicion(contadores(), OP_BUSCAR);
+	Nodo* proceso = dameProceso(p);
+	assert(proceso != NULL);
+	return !(proceso->pausado);
 }
 
 /**
  * Informa si existen procesos planificados.
  */
-template<class T>
-bool PlanificadorRR<T>::hayProcesos() const{
-	return cantidadProcesos > 0;
+template<class T, class Hash, class Asignador, class Estadisticas>
+bool PlanificadorRR<T, Hash, Asignador, Estadisticas>::hayProcesos() const{
+	return rep->cantidadProcesos > 0;
 }
 
 /**
  * Informa si existen procesos activos.
  */
-template<class T>
-bool PlanificadorRR<T>::hayProcesosActivos() const{
-	return cantidadDeProcesosActivos() > 0;
+template<class T, class Hash, class Asignador, class Estadisticas>
+bool PlanificadorRR<T, Hash, Asignador, Estadisticas>::hayProcesosActivos() const{
+	return rep->cantidadActivos > 0;
 }
 
 /**
  * Devuelve la cantidad de procesos planificados.
  */
-template<class T>
-int PlanificadorRR<T>::cantidadDeProcesos() const{
-	return cantidadProcesos;
+template<class T, class Hash, class Asignador, class Estadisticas>
+int PlanificadorRR<T, Hash, Asignador, Estadisticas>::cantidadDeProcesos() const{
+	return rep->cantidadProcesos;
 }
 
 /**
  * Devuelve la cantidad de procesos planificados y activos.
  */
-template<class T>
-int PlanificadorRR<T>::cantidadDeProcesosActivos() const{
-	if(cantidadProcesos > 0){
-		int procesosActivos = 0;
-		int i = 0;
-		Nodo* actual = procesoActual;
-		for (i=0; i < cantidadProcesos; i++) {
-			if (!actual->pausado) {
-				procesosActivos++;
-			}
-			actual = actual->siguiente;
-		}
-		return procesosActivos;
-	}
-	return 0;
+template<class T, class Hash, class Asignador, class Estadisticas>
+int PlanificadorRR<T, Hash, Asignador, Estadisticas>::cantidadDeProcesosActivos() const{
+	return rep->cantidadActivos;
 }
 
 /**
  * Devuelve true si ambos planificadores son iguales.
+ * Si hay hash, las huellas distintas descartan la igualdad en O(1); si no,
+ * recorre ambos anillos a la par una sola vez.
  */
-template<class T>
-bool PlanificadorRR<T>::operator==(const PlanificadorRR<T>& p) const{
-	if (cantidadProcesos == 0 && p.cantidadDeProcesos() == 0){
+template<class T, class Hash, class Asignador, class Estadisticas>
+bool PlanificadorRR<T, Hash, Asignador, Estadisticas>::operator==(const PlanificadorRR<T, Hash, Asignador, Estadisticas>& p) const{
+	Medicion medicion(contadores(), OP_COMPARAR);
+	if (rep->cantidadProcesos == 0 && p.rep->cantidadProcesos == 0){
+		return true;
+	}
+	if (rep->cantidadProcesos != p.rep->cantidadProcesos || planificadorDetenido != p.planificadorDetenido){
+		return false;
+	}
+	if (rep == p.rep && procesoActual == p.procesoActual){
+		// Comparten los nodos y están en el mismo proceso
 		return true;
 	}
-	bool result = (cantidadProcesos == p.cantidadDeProcesos()) && p.detenido() == planificadorDetenido;
-	if (!result){
+	if (Huella::habilitada && huella() != p.huella()){
 		return false;
 	}
-	int i = 1;
-	T pid = p.procesoEjecutado();
-	result = procesoActual->pid == pid && procesoActual->pausado == !p.estaActivo(pid);
-	Nodo* it1 = procesoActual->siguiente;
-	Nodo* it2 = p.procesoActual->siguiente;
-	while (result && i<cantidadProcesos){
-		result = result && it1->pid == it2->pid && it1->pausado == !p.estaActivo(it2->pid);
+	Nodo* it1 = procesoActual;
+	Nodo* it2 = p.procesoActual;
+	for (int i = 0; i < rep->cantidadProcesos; i++){
+		if (!(it1->pid == it2->pid) || it1->pausado != it2->pausado){
+			contadores().contarSaltos(2 * i);
+			return false;
+		}
 		it1 = it1->siguiente;
 		it2 = it2->siguiente;
-		i++;
 	}
-	return result; //result;
+	contadores().contarSaltos(2 * rep->cantidadProcesos);
+	return true;
+}
 
+/**
+ * Devuelve una huella del estado que depende del orden de ejecución, de
+ * qué procesos están pausados, del proceso actual y de si está detenido.
+ * Planificadores iguales tienen la misma huella; se mantiene en cada
+ * operación, así que consultarla cuesta O(1). Sin hash (SinHash) es la
+ * misma para todos los planificadores con la misma cantidad de procesos.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+size_t PlanificadorRR<T, Hash, Asignador, Estadisticas>::huella() const{
+	if (rep->cantidadProcesos == 0){
+		return 0;
+	}
+	uint64_t h = rep->huellaAristas;
+	h = mezclarHuella(h ^ (rep->huellaPausados * 0x9E3779B97F4A7C15ull));
+	h = mezclarHuella(h + Huella::de(procesoActual->pid) + (uint64_t)rep->cantidadProcesos);
+	return (size_t)(planificadorDetenido ? ~h : h);
 }
 
 /**
@@ -412,53 +1204,510 @@ bool PlanificadorRR<T>::operator==(const PlanificadorRR<T>& p) const{
  * para cada proceso, es decir, cómo cada proceso decide mostrarse en el sistema.
  * El sufijo 'X' indica el orden relativo de cada proceso en el planificador.
  */
-template<class T>
-ostream& PlanificadorRR<T>::mostrarPlanificadorRR(ostream& os) const{
-	if(cantidadProcesos == 0){
-			os << "[]";
-	}else{
-		os <<"[";
-		Nodo* mostrado = procesoActual;
-		int i=0;
-		while(i<cantidadProcesos){
-			os<<mostrado->pid;
-			if(mostrado->pausado){
-				os<<" (i)";
-			}else if(procesoActual == mostrado){
-				os<<"*";
-			}
-			i++;
-			if (i==cantidadProcesos){
-				os<<"]";
-			}else{
-				os<<", ";
-			}
-			mostrado = mostrado->siguiente;
+template<class T, class Hash, class Asignador, class Estadisticas>
+ostream& PlanificadorRR<T, Hash, Asignador, Estadisticas>::mostrarPlanificadorRR(ostream& os) const{
+	return mostrarPlanificadorRR(os, 0, rep->cantidadProcesos);
+}
+
+/**
+ * Muestra, con el mismo formato, sólo cantidad procesos a partir del que
+ * está en la posición desde del orden de ejecución (el actual es el 0).
+ * Llegar al primero cuesta O(log n) con el árbol de posiciones. Con pids
+ * enteros y el ostream sin formato especial, arma el texto en un buffer
+ * propio y lo escribe de a bloques.
+ * PRE: desde >= 0 y cantidad >= 0.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+ostream& PlanificadorRR<T, Hash, Asignador, Estadisticas>::mostrarPlanificadorRR(ostream& os, int desde, int cantidad) const{
+	Medicion medicion(contadores(), OP_MOSTRAR);
+	assert(desde >= 0 && cantidad >= 0);
+	return mostrarPagina(os, desde, cantidad, integral_constant<bool, SeMuestraConToChars<T>::valor>());
+}
+
+template<class T, class Hash, class Asignador, class Estadisticas>
+ostream& PlanificadorRR<T, Hash, Asignador, Estadisticas>::mostrarPagina(ostream& os, int desde, int cantidad, true_type) const{
+	if(os.flags() != (ios::skipws | ios::dec) || os.width() != 0){
+		return mostrarPagina(os, desde, cantidad, false_type());
+	}
+	char buffer[4096];
+	char* cursor = buffer;
+	*cursor++ = '[';
+	cantidad = entradasDePagina(desde, cantidad);
+	const Nodo* mostrado = nodoEnPosicion(desde);
+	for(int i = 0; i < cantidad; i++){
+		if(buffer + sizeof(buffer) - cursor < LARGO_MAXIMO_DE_ENTRADA){
+			os.write(buffer, cursor - buffer);
+			cursor = buffer;
+		}
+		if(i > 0){
+			*cursor++ = ',';
+			*cursor++ = ' ';
 		}
+		cursor = escribirEntrada(cursor, mostrado);
+		mostrado = mostrado->siguiente;
+	}
+	*cursor++ = ']';
+	os.write(buffer, cursor - buffer);
+	return os;
+}
 
+template<class T, class Hash, class Asignador, class Estadisticas>
+ostream& PlanificadorRR<T, Hash, Asignador, Estadisticas>::mostrarPagina(ostream& os, int desde, int cantidad, false_type) const{
+	os << "[";
+	cantidad = entradasDePagina(desde, cantidad);
+	const Nodo* mostrado = nodoEnPosicion(desde);
+	for(int i = 0; i < cantidad; i++){
+		if(i > 0){
+			os << ", ";
+		}
+		os << mostrado->pid;
+		if(mostrado->pausado){
+			os << " (i)";
+		}else if(procesoActual == mostrado){
+			os << "*";
+		}
+		mostrado = mostrado->siguiente;
 	}
-	// return os;
+	os << "]";
+	return os;
 }
 
-template<class T>
-ostream& operator<<(ostream& out, const PlanificadorRR<T>& a) {
+/**
+ * Escribe en [inicio, fin) lo mismo que mostrarPlanificadorRR(os, desde,
+ * cantidad), sin pedir memoria ni pasar por un ostream. Devuelve dónde
+ * termina lo escrito, o NULL si no entra (y entonces el contenido del
+ * buffer queda indefinido). No agrega el '\0' final.
+ * PRE: Los pids son enteros (SeMuestraConToChars).
+ * PRE: desde >= 0 y cantidad >= 0.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+char* PlanificadorRR<T, Hash, Asignador, Estadisticas>::mostrarEn(char* inicio, char* fin, int desde, int cantidad) const{
+	static_assert(SeMuestraConToChars<T>::valor, "mostrarEn necesita pids enteros");
+	Medicion medicion(contadores(), OP_MOSTRAR);
+	assert(desde >= 0 && cantidad >= 0);
+	cantidad = entradasDePagina(desde, cantidad);
+	char* cursor = inicio;
+	if(fin - cursor < 2){
+		return NULL;
+	}
+	*cursor++ = '[';
+	const Nodo* mostrado = nodoEnPosicion(desde);
+	char entrada[LARGO_MAXIMO_DE_ENTRADA];
+	for(int i = 0; i < cantidad; i++){
+		char* finDeEntrada = entrada;
+		if(i > 0){
+			*finDeEntrada++ = ',';
+			*finDeEntrada++ = ' ';
+		}
+		finDeEntrada = escribirEntrada(finDeEntrada, mostrado);
+		// Se deja lugar para el ']'
+		if(fin - cursor <= finDeEntrada - entrada){
+			return NULL;
+		}
+		memcpy(cursor, entrada, finDeEntrada - entrada);
+		cursor += finDeEntrada - entrada;
+		mostrado = mostrado->siguiente;
+	}
+	*cursor++ = ']';
+	return cursor;
+}
+
+/**
+ * Devuelve el mismo texto que escribe mostrarPlanificadorRR. Se guarda y
+ * sólo se vuelve a generar si el planificador cambió (o ejecutó otro
+ * proceso) desde la última llamada; al regenerarlo se reusa la memoria
+ * del anterior. La referencia vale hasta la próxima modificación.
+ * No se puede llamar desde dos hilos a la vez sobre el mismo planificador.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+const string& PlanificadorRR<T, Hash, Asignador, Estadisticas>::mostrado() const{
+	if(mostradoEnCache == NULL){
+		mostradoEnCache = new Mostrado();
+	}else if(mostradoEnCache->version == version && mostradoEnCache->actual == procesoActual){
+		return mostradoEnCache->texto;
+	}
+	generarMostrado(mostradoEnCache->texto, integral_constant<bool, SeMuestraConToChars<T>::valor>());
+	mostradoEnCache->version = version;
+	mostradoEnCache->actual = procesoActual;
+	return mostradoEnCache->texto;
+}
+
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::generarMostrado(string& texto, true_type) const{
+	texto.resize(2 + (size_t)rep->cantidadProcesos * LARGO_MAXIMO_DE_ENTRADA);
+	char* fin = mostrarEn(&texto[0], &texto[0] + texto.size());
+	texto.resize(fin - &texto[0]);
+}
+
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::generarMostrado(string& texto, false_type) const{
+	ostringstream os;
+	mostrarPlanificadorRR(os);
+	texto = os.str();
+}
+
+template<class T, class Hash, class Asignador, class Estadisticas>
+ostream& operator<<(ostream& out, const PlanificadorRR<T, Hash, Asignador, Estadisticas>& a) {
 	return a.mostrarPlanificadorRR(out);
 }
 
+/**
+ * Vuelve a ubicar los nodos en memoria en orden de ejecución, empezando
+ * por el proceso actual, para que recorrer el anillo lea la memoria en
+ * forma secuencial. Si el asignador permite liberar por partes (como
+ * AsignadorPool), los nodos nuevos se piden en un único bloque contiguo;
+ * si no, se piden de a uno en ese mismo orden.
+ * No cambia el estado observable del planificador.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::reubicarEnOrden(){
+	separar();
+	if(rep->cantidadProcesos == 0){
+		return;
+	}
+	bool contiguo = LiberaPorPartes<AsignadorDeNodos>::valor;
+	Nodo* bloque = contiguo ? RasgosDeAsignador::allocate(rep->asignador, rep->cantidadProcesos) : NULL;
+	// Primera pasada: copia cada nodo y deja en su campo anterior el nodo nuevo
+	Nodo* viejo = procesoActual;
+	Nodo* primero = NULL;
+	Nodo* ultimo = NULL;
+	int i;
+	for(i = 0; i < rep->cantidadProcesos; i++){
+		Nodo* nuevo = contiguo ? bloque + i : RasgosDeAsignador::allocate(rep->asignador, 1);
+		contadores().contarAsignaciones(1);
+		RasgosDeAsignador::construct(rep->asignador, nuevo, viejo->pid);
+		nuevo->pausado = viejo->pausado;
+		if(ultimo == NULL){
+			primero = nuevo;
+		}else{
+			ultimo->siguiente = nuevo;
+			nuevo->anterior = ultimo;
+		}
+		ultimo = nuevo;
+		Nodo* siguienteViejo = viejo->siguiente;
+		viejo->anterior = nuevo;
+		viejo = siguienteViejo;
+	}
+	ultimo->siguiente = primero;
+	primero->anterior = ultimo;
+	// Segunda pasada: traduce los anillos de estado
+	Nodo* nuevo = primero;
+	for(i = 0; i < rep->cantidadProcesos; i++){
+		nuevo->siguienteEnEstado = viejo->siguienteEnEstado->anterior;
+		nuevo->anteriorEnEstado = viejo->anteriorEnEstado->anterior;
+		rep->indice.insertar(nuevo->pid, nuevo);
+		viejo = viejo->siguiente;
+		nuevo = nuevo->siguiente;
+	}
+	if(rep->pausados != NULL){
+		rep->pausados = rep->pausados->anterior;
+	}
+	rep->posiciones.template armar<&Nodo::siguiente>(primero, rep->cantidadProcesos);
+	// Tercera pasada: libera los nodos viejos
+	for(i = 0; i < rep->cantidadProcesos; i++){
+		Nodo* siguienteViejo = viejo->siguiente;
+		destruirNodo(viejo);
+		viejo = siguienteViejo;
+	}
+	procesoActual = primero;
+}
+
 //Metodos auxiliares
-template<class T>
-typename PlanificadorRR<T>::Nodo* PlanificadorRR<T>::dameProceso(const T& p){
+template<class T, class Hash, class Asignador, class Estadisticas>
+typename PlanificadorRR<T, Hash, Asignador, Estadisticas>::Nodo* PlanificadorRR<T, Hash, Asignador, Estadisticas>::dameProceso(const T& p) const{
+	if(rep->indice.habilitado){
+		// Los muertos siguen en el índice hasta compactar
+		Nodo* encontrado = rep->indice.buscar(p, NULL);
+		return encontrado != NULL && !encontrado->muerto ? encontrado : NULL;
+	}
 	int i;
 	Nodo* actual = procesoActual;
-	for (i=0; i < cantidadProcesos; i++) {
+	for (i=0; i < rep->cantidadProcesos; i++) {
 		if (actual->pid == p) {
+			contadores().contarSaltos(i);
 			return actual;
 		} else {
 			actual = actual->siguiente;
 		}
 	}
 	// cout << "No existe";
+	contadores().contarSaltos(rep->cantidadProcesos);
 	return NULL;
 }
 
-#endif // PLANIFICADOR_RR_H_
\ No newline at end of file
+/**
+ * Devuelve el activo más cercano que precede a un proceso pausado en el
+ * orden de ejecución. Recorre la racha de pausados hacia ambos lados a la
+ * vez, así que cuesta lo que la más corta de las dos.
+ * PRE: Hay al menos un proceso activo.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+typename PlanificadorRR<T, Hash, Asignador, Estadisticas>::Nodo* PlanificadorRR<T, Hash, Asignador, Estadisticas>::anteriorActivo(Nodo* p) const{
+	Nodo* atras = p->anterior;
+	Nodo* adelante = p->siguiente;
+	long saltos = 2;
+	while(atras->pausado && adelante->pausado){
+		atras = atras->anterior;
+		adelante = adelante->siguiente;
+		saltos += 2;
+	}
+	contadores().contarSaltos(saltos);
+	return atras->pausado ? adelante->anteriorEnEstado : atras;
+}
+
+/**
+ * Agrega un nodo al final de un anillo de estado, es decir, inmediatamente
+ * antes de cabeza. Si el anillo está vacío, el nodo pasa a ser la cabeza.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::enlazarEnEstado(Nodo*& cabeza, Nodo* n){
+	if(cabeza == NULL){
+		cabeza = n;
+		n->siguienteEnEstado = n;
+		n->anteriorEnEstado = n;
+	}else{
+		n->siguienteEnEstado = cabeza;
+		n->anteriorEnEstado = cabeza->anteriorEnEstado;
+		cabeza->anteriorEnEstado->siguienteEnEstado = n;
+		cabeza->anteriorEnEstado = n;
+	}
+}
+
+/**
+ * Saca un nodo de su anillo de estado. Si era la cabeza, la cabeza pasa
+ * al siguiente (o a NULL si era el único).
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::desenlazarDeEstado(Nodo*& cabeza, Nodo* n){
+	if(n->siguienteEnEstado == n){
+		cabeza = NULL;
+	}else{
+		n->anteriorEnEstado->siguienteEnEstado = n->siguienteEnEstado;
+		n->siguienteEnEstado->anteriorEnEstado = n->anteriorEnEstado;
+		if(cabeza == n){
+			cabeza = n->siguienteEnEstado;
+		}
+	}
+}
+
+template<class T, class Hash, class Asignador, class Estadisticas>
+template<typename... Argumentos>
+typename PlanificadorRR<T, Hash, Asignador, Estadisticas>::Nodo* PlanificadorRR<T, Hash, Asignador, Estadisticas>::crearNodo(Argumentos&&... argumentos){
+	Nodo* n = RasgosDeAsignador::allocate(rep->asignador, 1);
+	contadores().contarAsignaciones(1);
+	RasgosDeAsignador::construct(rep->asignador, n, std::forward<Argumentos>(argumentos)...);
+	return n;
+}
+
+/**
+ * Huella del par (a, b), con b inmediatamente después de a. Distingue
+ * (a, b) de (b, a), así que la suma de todos los pares fija el orden.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+uint64_t PlanificadorRR<T, Hash, Asignador, Estadisticas>::huellaArista(const Nodo* a, const Nodo* b){
+	if (!Huella::habilitada){
+		return 0;
+	}
+	uint64_t hb = Huella::de(b->pid);
+	return mezclarHuella(Huella::de(a->pid) ^ ((hb << 32) | (hb >> 32)) ^ 0xD6E8FEB86659FD93ull);
+}
+
+/**
+ * Devuelve, con una referencia más, la representación vacía compartida
+ * por los planificadores recién creados y los vaciados por movimiento.
+ * Se construye una sola vez en memoria estática y nunca se libera ni se
+ * destruye, así que obtenerla no reserva memoria ni puede fallar: el
+ * índice vacío y los asignadores recién creados tampoco la piden.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+typename PlanificadorRR<T, Hash, Asignador, Estadisticas>::Representacion* PlanificadorRR<T, Hash, Asignador, Estadisticas>::representacionVacia() noexcept{
+	// Sin destructor, sigue valiendo para los planificadores estáticos
+	// que se destruyen después
+	alignas(Representacion) static unsigned char memoria[sizeof(Representacion)];
+	static Representacion* vacia = new(memoria) Representacion(AsignadorDeNodos());
+	vacia->referencias++;
+	return vacia;
+}
+
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::destruirNodo(Nodo* n){
+	RasgosDeAsignador::destroy(rep->asignador, n);
+	RasgosDeAsignador::deallocate(rep->asignador, n, 1);
+	contadores().contarLiberaciones(1);
+}
+
+/**
+ * Deja de usar una representación. Si era el último que la usaba, destruye
+ * sus nodos en una pasada (empezando por actual, que es uno de ellos),
+ * los muertos que quedaban por compactar, y la libera.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::soltar(Representacion* r, Nodo* actual){
+	if(--r->referencias > 0){
+		return;
+	}
+	for(int i = 0; i < r->cantidadProcesos; i++){
+		Nodo* siguiente = actual->siguiente;
+		RasgosDeAsignador::destroy(r->asignador, actual);
+		RasgosDeAsignador::deallocate(r->asignador, actual, 1);
+		actual = siguiente;
+	}
+	while(r->muertos != NULL){
+		Nodo* siguiente = r->muertos->siguienteEnEstado;
+		RasgosDeAsignador::destroy(r->asignador, r->muertos);
+		RasgosDeAsignador::deallocate(r->asignador, r->muertos, 1);
+		r->muertos = siguiente;
+	}
+	contadores().contarLiberaciones(r->cantidadProcesos + r->cantidadMuertos);
+	delete r;
+}
+
+/**
+ * Devuelve el nodo en la posición k del orden de ejecución, contando
+ * desde el actual, en O(log n) con el árbol de posiciones. Si k no es una
+ * posición válida, devuelve NULL.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+const typename PlanificadorRR<T, Hash, Asignador, Estadisticas>::Nodo* PlanificadorRR<T, Hash, Asignador, Estadisticas>::nodoEnPosicion(int k) const{
+	int total = rep->cantidadProcesos;
+	if(k < 0 || k >= total){
+		return NULL;
+	}
+	if(k == 0){
+		return procesoActual;
+	}
+	return rep->posiciones.enPosicion((rep->posiciones.posicion(procesoActual) + k) % total);
+}
+
+/**
+ * Cuántos procesos tiene la página de cantidad procesos desde la
+ * posición desde, recortada al final del orden de ejecución.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+int PlanificadorRR<T, Hash, Asignador, Estadisticas>::entradasDePagina(int desde, int cantidad) const{
+	if(desde >= rep->cantidadProcesos){
+		return 0;
+	}
+	int restantes = rep->cantidadProcesos - desde;
+	if(cantidad < restantes){
+		restantes = cantidad;
+	}
+	contadores().contarSaltos(restantes);
+	return restantes;
+}
+
+/**
+ * Escribe el pid del nodo con su marca de pausado o de actual.
+ * PRE: Hay al menos LARGO_MAXIMO_DE_ENTRADA - 2 lugares desde cursor.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+char* PlanificadorRR<T, Hash, Asignador, Estadisticas>::escribirEntrada(char* cursor, const Nodo* nodo) const{
+	cursor = to_chars(cursor, cursor + LARGO_MAXIMO_DE_ENTRADA - 2, nodo->pid).ptr;
+	if(nodo->pausado){
+		memcpy(cursor, " (i)", 4);
+		cursor += 4;
+	}else if(nodo == procesoActual){
+		*cursor++ = '*';
+	}
+	return cursor;
+}
+
+/**
+ * Si la representación está compartida con otra copia, la copia entera
+ * para que este planificador tenga una propia. Todas las operaciones que
+ * modifican los nodos la llaman primero: la primera modificación después
+ * de copiar cuesta O(n) y las siguientes, lo de siempre. Como la llaman
+ * todas, también es donde se invalida lo guardado por mostrado().
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+void PlanificadorRR<T, Hash, Asignador, Estadisticas>::separar(){
+	version++;
+	if(rep->referencias == 1){
+		return;
+	}
+	Representacion* vieja = rep;
+	Nodo* copia = procesoActual;
+	rep = new Representacion(asignadorPropio());
+	procesoActual = NULL;
+	if(vieja->cantidadProcesos > 0){
+		// Separarse de la representación vacía compartida no se cuenta
+		Medicion medicion(contadores(), OP_SEPARAR);
+		contadores().contarSaltos(2 * vieja->cantidadProcesos);
+		rep->cantidadProcesos = vieja->cantidadProcesos;
+		rep->cantidadActivos = vieja->cantidadActivos;
+		rep->huellaAristas = vieja->huellaAristas;
+		rep->huellaPausados = vieja->huellaPausados;
+		rep->indice.reservar(rep->cantidadProcesos);
+		procesoActual = crearNodo(copia->pid);
+		procesoActual->pausado = copia->pausado;
+		rep->indice.insertar(procesoActual->pid, procesoActual);
+		Nodo* actual = procesoActual;
+		for(int i = 1; i < rep->cantidadProcesos; i++){
+			copia = copia->siguiente;
+			Nodo* siguiente = crearNodo(copia->pid);
+			siguiente->pausado = copia->pausado;
+			siguiente->anterior = actual;
+			actual->siguiente = siguiente;
+			actual = siguiente;
+			rep->indice.insertar(actual->pid, actual);
+		}
+		actual->siguiente = procesoActual;
+		procesoActual->anterior = actual;
+		// Los anillos de estado se arman en orden de ejecución
+		Nodo* activos = NULL;
+		actual = procesoActual;
+		for(int i = 0; i < rep->cantidadProcesos; i++){
+			enlazarEnEstado(actual->pausado ? rep->pausados : activos, actual);
+			actual = actual->siguiente;
+		}
+		rep->posiciones.template armar<&Nodo::siguiente>(procesoActual, rep->cantidadProcesos);
+	}
+	soltar(vieja, copia);
+}
+
+/**
+ * Devuelve el asignador para una representación nueva de este
+ * planificador: el de la actual si es sólo suya, o el que le corresponde
+ * a una copia si la comparte. Así las copias no comparten el estado del
+ * asignador (la arena de AsignadorPool, por ejemplo), que puede no ser
+ * seguro entre hilos.
+ */
+template<class T, class Hash, class Asignador, class Estadisticas>
+typename PlanificadorRR<T, Hash, Asignador, Estadisticas>::AsignadorDeNodos PlanificadorRR<T, Hash, Asignador, Estadisticas>::asignadorPropio() const{
+	if(rep->referencias == 1){
+		return rep->asignador;
+	}
+	return RasgosDeAsignador::select_on_container_copy_construction(rep->asignador);
+}
+
+/**
+ * Políticas de almacenamiento de los procesos. PlanificadorSegun<T, A>::tipo
+ * es el planificador de procesos T que usa el almacenamiento A.
+ * AlmacenamientoEnlazado es la lista circular de nodos de PlanificadorRR;
+ * los demás almacenamientos se definen junto a sus planificadores.
+ */
+struct AlmacenamientoEnlazado {};
+
+template<typename T, typename Almacenamiento>
+struct PlanificadorSegun;
+
+template<typename T>
+struct PlanificadorSegun<T, AlmacenamientoEnlazado> {
+	typedef PlanificadorRR<T> tipo;
+};
+
+namespace std {
+
+/**
+ * Permite usar planificadores como claves de unordered_map y unordered_set.
+ */
+template<typename T, typename Hash, typename Asignador, typename Estadisticas>
+struct hash<PlanificadorRR<T, Hash, Asignador, Estadisticas> > {
+	size_t operator()(const PlanificadorRR<T, Hash, Asignador, Estadisticas>& p) const {
+		return p.huella();
+	}
+};
+
+}
+
+#endif // PLANIFICADOR_RR_H_
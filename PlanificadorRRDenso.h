@@ -0,0 +1,472 @@
+#ifndef PLANIFICADOR_RR_DENSO_H_
+#define PLANIFICADOR_RR_DENSO_H_
+
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * Planificador Round Robin con la misma interfaz y el mismo comportamiento
+ * que PlanificadorRR, para pids enteros entre 0 y MaxPid. Los enlaces de
+ * cada proceso están en un arreglo indexado directamente por el pid, y si
+ * está planificado o pausado, en dos bitmaps. Como PlanificadorRR, además
+ * del anillo de todos los procesos mantiene el de los activos, así que
+ * ejecutar el siguiente no pasa por los pausados.
+ *
+ * Buscar un proceso es leer su posición en el arreglo: no hay hash ni
+ * índice, y toda la memoria (16 bytes y 2 bits por pid posible) se pide
+ * al construirlo, así que las operaciones no piden memoria. Además, todos
+ * los planificadores con el mismo T y MaxPid comparten una tabla de sólo
+ * lectura con los pids posibles, de la que procesoEjecutado devuelve la
+ * referencia.
+ */
+template<typename T, uint32_t MaxPid>
+class PlanificadorRRDenso {
+
+	static_assert(is_integral<T>::value, "PlanificadorRRDenso necesita pids enteros");
+	static_assert(MaxPid < 0xFFFFFFFFu, "MaxPid no puede ser el máximo de 32 bits");
+
+  public:
+
+	PlanificadorRRDenso();
+	PlanificadorRRDenso(const PlanificadorRRDenso<T, MaxPid>&);
+	void agregarProceso(const T&);
+	void eliminarProceso(const T&);
+	const T& procesoEjecutado() const;
+	void ejecutarSiguienteProceso();
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+	void detener();
+	void reanudar();
+	bool detenido() const;
+	bool esPlanificado(const T&) const;
+	bool estaActivo(const T&) const;
+	bool hayProcesos() const;
+	bool hayProcesosActivos() const;
+	int cantidadDeProcesos() const;
+	int cantidadDeProcesosActivos() const;
+	bool operator==(const PlanificadorRRDenso<T, MaxPid>&) const;
+	ostream& mostrarPlanificadorRR(ostream&) const;
+
+  private:
+
+	PlanificadorRRDenso<T, MaxPid>& operator=(const PlanificadorRRDenso<T, MaxPid>& otra) {
+		assert(false);
+		return *this;
+	}
+
+	static const uint32_t NINGUNO = 0xFFFFFFFFu;
+
+	/**
+	 * siguiente y anterior enlazan a todos los procesos en orden de
+	 * ejecución; siguienteActivo y anteriorActivo, sólo a los activos.
+	 */
+	struct Enlaces {
+		uint32_t siguiente;
+		uint32_t anterior;
+		uint32_t siguienteActivo;
+		uint32_t anteriorActivo;
+	};
+
+	static uint32_t posicion(const T&);
+	static bool enRango(const T&);
+	static bool noNegativo(const T&, true_type);
+	static bool noNegativo(const T&, false_type);
+	static const T* pidsPosibles();
+	static bool bit(const vector<uint64_t>&, uint32_t);
+	static void marcar(vector<uint64_t>&, uint32_t, bool);
+	void enlazarActivo(uint32_t, uint32_t);
+	void desenlazarActivo(uint32_t);
+	uint32_t anteriorActivo(uint32_t) const;
+
+	// Si hay procesos activos, actual es uno de ellos
+	vector<Enlaces> enlaces;
+	vector<uint64_t> planificados;
+	vector<uint64_t> pausados;
+	uint32_t actual;
+	int cantidad;
+	int cantidadActivos;
+	bool planificadorDetenido;
+	// pids[k] == k, para devolver referencias a los pids (ver pidsPosibles)
+	const T* pids;
+};
+
+/**
+ * Almacenamiento denso para pids enteros entre 0 y MaxPid (ver
+ * PlanificadorRRDenso).
+ */
+template<uint32_t MaxPid>
+struct AlmacenamientoDenso {};
+
+template<typename T, uint32_t MaxPid>
+struct PlanificadorSegun<T, AlmacenamientoDenso<MaxPid> > {
+	typedef PlanificadorRRDenso<T, MaxPid> tipo;
+};
+
+/**
+ * Crea un nuevo planificador de tipo Round Robin, con lugar para todos
+ * los pids entre 0 y MaxPid.
+ */
+template<class T, uint32_t MaxPid>
+PlanificadorRRDenso<T, MaxPid>::PlanificadorRRDenso():
+	enlaces((size_t)MaxPid + 1), planificados((size_t)MaxPid / 64 + 1, 0), pausados((size_t)MaxPid / 64 + 1, 0){
+	actual = NINGUNO;
+	cantidad = 0;
+	cantidadActivos = 0;
+	planificadorDetenido = false;
+	pids = pidsPosibles();
+}
+
+/**
+ * La copia tiene sus propios enlaces y bitmaps: es independiente del
+ * original.
+ */
+template<class T, uint32_t MaxPid>
+PlanificadorRRDenso<T, MaxPid>::PlanificadorRRDenso(const PlanificadorRRDenso<T, MaxPid>& p):
+	enlaces(p.enlaces), planificados(p.planificados), pausados(p.pausados){
+	actual = p.actual;
+	cantidad = p.cantidad;
+	cantidadActivos = p.cantidadActivos;
+	planificadorDetenido = p.planificadorDetenido;
+	pids = p.pids;
+}
+
+/**
+ * Agrega un proceso inmediatamente antes del que está siendo ejecutado,
+ * también entre los activos. Si no hay ningún proceso en ejecución, pasa
+ * a ser ejecutado.
+ * PRE: 0 <= pid <= MaxPid.
+ * PRE: El proceso no está siendo planificado por el planificador.
+ */
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::agregarProceso(const T& pid){
+	uint32_t nuevo = posicion(pid);
+	assert(!bit(planificados, nuevo));
+	Enlaces& e = enlaces[nuevo];
+	if(cantidad == 0){
+		e.siguiente = nuevo;
+		e.anterior = nuevo;
+		actual = nuevo;
+	}else{
+		uint32_t ultimo = enlaces[actual].anterior;
+		e.siguiente = actual;
+		e.anterior = ultimo;
+		enlaces[ultimo].siguiente = nuevo;
+		enlaces[actual].anterior = nuevo;
+	}
+	if(cantidadActivos == 0){
+		actual = nuevo;
+		e.siguienteActivo = nuevo;
+		e.anteriorActivo = nuevo;
+	}else{
+		enlazarActivo(enlaces[actual].anteriorActivo, nuevo);
+	}
+	marcar(planificados, nuevo, true);
+	cantidadActivos++;
+	cantidad++;
+}
+
+/**
+ * Elimina un proceso. Si estaba en ejecución, pasa a ejecutarse el
+ * siguiente activo (si es que existe).
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::eliminarProceso(const T& p){
+	uint32_t k = posicion(p);
+	assert(bit(planificados, k));
+	Enlaces& e = enlaces[k];
+	if(!bit(pausados, k)){
+		uint32_t siguiente = e.siguienteActivo;
+		desenlazarActivo(k);
+		cantidadActivos--;
+		if(k == actual && cantidadActivos > 0){
+			actual = siguiente;
+		}
+	}
+	if(k == actual){
+		actual = cantidad > 1 ? e.siguiente : NINGUNO;
+	}
+	enlaces[e.anterior].siguiente = e.siguiente;
+	enlaces[e.siguiente].anterior = e.anterior;
+	marcar(planificados, k, false);
+	marcar(pausados, k, false);
+	cantidad--;
+}
+
+/**
+ * Devuelve el proceso que está actualmente en ejecución. La referencia
+ * es a la tabla de pids posibles, así que sigue valiendo aunque el
+ * planificador cambie.
+ * PRE: Hay al menos un proceso en el planificador.
+ */
+template<class T, uint32_t MaxPid>
+const T& PlanificadorRRDenso<T, MaxPid>::procesoEjecutado() const{
+	assert(cantidad > 0);
+	return pids[actual];
+}
+
+/**
+ * Procede a ejecutar el siguiente proceso activo.
+ * PRE: Hay al menos un proceso activo en el planificador.
+ */
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::ejecutarSiguienteProceso(){
+	assert(cantidadActivos > 0);
+	actual = enlaces[actual].siguienteActivo;
+}
+
+/**
+ * Pausa un proceso. Si estaba en ejecución, pasa a ejecutarse el
+ * siguiente activo (si es que existe).
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está activo.
+ */
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::pausarProceso(const T& p){
+	uint32_t k = posicion(p);
+	assert(bit(planificados, k) && !bit(pausados, k));
+	uint32_t siguiente = enlaces[k].siguienteActivo;
+	desenlazarActivo(k);
+	cantidadActivos--;
+	if(k == actual && cantidadActivos > 0){
+		actual = siguiente;
+	}
+	marcar(pausados, k, true);
+}
+
+/**
+ * Reanuda un proceso pausado, en el mismo lugar que tenía entre los
+ * activos. Si no había ningún proceso en ejecución, pasa a ser ejecutado.
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está inactivo.
+ */
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::reanudarProceso(const T& p){
+	uint32_t k = posicion(p);
+	assert(bit(planificados, k) && bit(pausados, k));
+	if(cantidadActivos == 0){
+		actual = k;
+		enlaces[k].siguienteActivo = k;
+		enlaces[k].anteriorActivo = k;
+	}else{
+		enlazarActivo(anteriorActivo(k), k);
+	}
+	marcar(pausados, k, false);
+	cantidadActivos++;
+}
+
+/**
+ * Detiene la ejecución de todos los procesos.
+ * PRE: El planificador no está detenido.
+ */
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::detener(){
+	assert(!planificadorDetenido);
+	planificadorDetenido = true;
+}
+
+/**
+ * Reanuda la ejecución de los procesos (activos).
+ * PRE: El planificador está detenido.
+ */
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::reanudar(){
+	assert(planificadorDetenido);
+	planificadorDetenido = false;
+}
+
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::detenido() const{
+	return planificadorDetenido;
+}
+
+/**
+ * Los pids fuera de rango no están planificados.
+ */
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::esPlanificado(const T& p) const{
+	return enRango(p) && bit(planificados, (uint32_t)p);
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::estaActivo(const T& p) const{
+	uint32_t k = posicion(p);
+	assert(bit(planificados, k));
+	return !bit(pausados, k);
+}
+
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::hayProcesos() const{
+	return cantidad > 0;
+}
+
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::hayProcesosActivos() const{
+	return cantidadActivos > 0;
+}
+
+template<class T, uint32_t MaxPid>
+int PlanificadorRRDenso<T, MaxPid>::cantidadDeProcesos() const{
+	return cantidad;
+}
+
+template<class T, uint32_t MaxPid>
+int PlanificadorRRDenso<T, MaxPid>::cantidadDeProcesosActivos() const{
+	return cantidadActivos;
+}
+
+/**
+ * Devuelve true si ambos planificadores son iguales.
+ */
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::operator==(const PlanificadorRRDenso<T, MaxPid>& p) const{
+	if(cantidad == 0 && p.cantidad == 0){
+		return true;
+	}
+	if(cantidad != p.cantidad || cantidadActivos != p.cantidadActivos
+			|| planificadorDetenido != p.planificadorDetenido){
+		return false;
+	}
+	uint32_t i = actual;
+	uint32_t j = p.actual;
+	for(int n = 0; n < cantidad; n++){
+		if(i != j || bit(pausados, i) != bit(p.pausados, j)){
+			return false;
+		}
+		i = enlaces[i].siguiente;
+		j = p.enlaces[j].siguiente;
+	}
+	return true;
+}
+
+/**
+ * Muestra los procesos en orden de ejecución con el mismo formato que
+ * PlanificadorRR::mostrarPlanificadorRR.
+ */
+template<class T, uint32_t MaxPid>
+ostream& PlanificadorRRDenso<T, MaxPid>::mostrarPlanificadorRR(ostream& os) const{
+	os << "[";
+	uint32_t i = actual;
+	for(int n = 0; n < cantidad; n++){
+		os << (T)i;
+		if(bit(pausados, i)){
+			os << " (i)";
+		}else if(i == actual){
+			os << "*";
+		}
+		if(n + 1 < cantidad){
+			os << ", ";
+		}
+		i = enlaces[i].siguiente;
+	}
+	os << "]";
+	return os;
+}
+
+template<class T, uint32_t MaxPid>
+ostream& operator<<(ostream& out, const PlanificadorRRDenso<T, MaxPid>& a) {
+	return a.mostrarPlanificadorRR(out);
+}
+
+//Metodos auxiliares
+template<class T, uint32_t MaxPid>
+uint32_t PlanificadorRRDenso<T, MaxPid>::posicion(const T& p){
+	assert(enRango(p));
+	return (uint32_t)p;
+}
+
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::enRango(const T& p){
+	return noNegativo(p, typename is_signed<T>::type()) && (uint64_t)p <= MaxPid;
+}
+
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::noNegativo(const T& p, true_type){
+	return p >= 0;
+}
+
+/**
+ * Sin signo no hay negativos; compararlos con 0 no tiene sentido.
+ */
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::noNegativo(const T&, false_type){
+	return true;
+}
+
+/**
+ * Devuelve la tabla de los pids entre 0 y MaxPid, que se arma la primera
+ * vez que se pide y después sólo se lee, así que la pueden leer varios
+ * hilos a la vez.
+ */
+template<class T, uint32_t MaxPid>
+const T* PlanificadorRRDenso<T, MaxPid>::pidsPosibles(){
+	static const vector<T> tabla = [](){
+		vector<T> pids;
+		pids.reserve((size_t)MaxPid + 1);
+		for(uint64_t k = 0; k <= MaxPid; k++){
+			pids.push_back((T)k);
+		}
+		return pids;
+	}();
+	return tabla.data();
+}
+
+template<class T, uint32_t MaxPid>
+bool PlanificadorRRDenso<T, MaxPid>::bit(const vector<uint64_t>& bits, uint32_t i){
+	return (bits[i >> 6] >> (i & 63)) & 1;
+}
+
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::marcar(vector<uint64_t>& bits, uint32_t i, bool valor){
+	uint64_t b = (uint64_t)1 << (i & 63);
+	if(valor){
+		bits[i >> 6] |= b;
+	}else{
+		bits[i >> 6] &= ~b;
+	}
+}
+
+/**
+ * Enlaza k entre los activos inmediatamente después de anterior.
+ */
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::enlazarActivo(uint32_t anterior, uint32_t k){
+	uint32_t siguiente = enlaces[anterior].siguienteActivo;
+	enlaces[k].anteriorActivo = anterior;
+	enlaces[k].siguienteActivo = siguiente;
+	enlaces[anterior].siguienteActivo = k;
+	enlaces[siguiente].anteriorActivo = k;
+}
+
+template<class T, uint32_t MaxPid>
+void PlanificadorRRDenso<T, MaxPid>::desenlazarActivo(uint32_t k){
+	Enlaces& e = enlaces[k];
+	enlaces[e.anteriorActivo].siguienteActivo = e.siguienteActivo;
+	enlaces[e.siguienteActivo].anteriorActivo = e.anteriorActivo;
+}
+
+/**
+ * Devuelve el activo que precede a k en orden de ejecución. Busca hacia
+ * los dos lados a la vez: el primer activo que encuentra atrás es el
+ * anterior, y si primero encuentra uno adelante, el anterior es el que
+ * lo precede entre los activos.
+ * PRE: Hay al menos un proceso activo.
+ */
+template<class T, uint32_t MaxPid>
+uint32_t PlanificadorRRDenso<T, MaxPid>::anteriorActivo(uint32_t k) const{
+	uint32_t atras = enlaces[k].anterior;
+	uint32_t adelante = enlaces[k].siguiente;
+	while(bit(pausados, atras) && bit(pausados, adelante)){
+		atras = enlaces[atras].anterior;
+		adelante = enlaces[adelante].siguiente;
+	}
+	return bit(pausados, atras) ? enlaces[adelante].anteriorActivo : atras;
+}
+
+#endif // PLANIFICADOR_RR_DENSO_H_
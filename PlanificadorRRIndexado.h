@@ -0,0 +1,494 @@
+#ifndef PLANIFICADOR_RR_INDEXADO_H_
+#define PLANIFICADOR_RR_INDEXADO_H_
+
+#include <stdint.h>
+#include <new>
+#include <vector>
+#include "BitmapDeProcesos.h"
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * Planificador Round Robin con la misma interfaz y el mismo comportamiento
+ * que PlanificadorRR, guardado como estructura de arreglos: los pids en
+ * un arreglo contiguo, el anillo como índices de 32 bits al siguiente y al
+ * anterior, y la pausa como un bit por proceso. Por proceso ocupa
+ * sizeof(T) + 8 bytes + 1 bit (más el índice por pid, si hay hash), y
+ * los recorridos leen arreglos densos en lugar de seguir punteros.
+ *
+ * Las posiciones no respetan el orden de ejecución: un proceso nuevo va
+ * al final de los arreglos y al eliminar uno, el último ocupa su lugar.
+ * reordenar() las vuelve a poner en orden, y mientras lo estén, buscar el
+ * siguiente activo es buscar el siguiente 0 en el bitmap de pausados, de
+ * a 64 procesos (o 256, con AVX2) por vez, sin recorrer los pausados.
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia y operator==
+ * No se puede asumir que el tipo T tenga operator=
+ */
+template<typename T, typename Hash = typename HashPorDefecto<T>::tipo>
+class PlanificadorRRIndexado {
+
+  public:
+
+	PlanificadorRRIndexado();
+	PlanificadorRRIndexado(const PlanificadorRRIndexado<T, Hash>&);
+	~PlanificadorRRIndexado();
+	void agregarProceso(const T&);
+	void eliminarProceso(const T&);
+	const T& procesoEjecutado() const;
+	void ejecutarSiguienteProceso();
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+	void detener();
+	void reanudar();
+	bool detenido() const;
+	bool esPlanificado(const T&) const;
+	bool estaActivo(const T&) const;
+	bool hayProcesos() const;
+	bool hayProcesosActivos() const;
+	int cantidadDeProcesos() const;
+	int cantidadDeProcesosActivos() const;
+	void reordenar();
+	bool ordenado() const;
+	bool operator==(const PlanificadorRRIndexado<T, Hash>&) const;
+	ostream& mostrarPlanificadorRR(ostream&) const;
+
+  private:
+
+	PlanificadorRRIndexado<T, Hash>& operator=(const PlanificadorRRIndexado<T, Hash>& otra) {
+		assert(false);
+		return *this;
+	}
+
+	static const uint32_t NINGUNO = 0xFFFFFFFFu;
+
+	uint32_t posicionDe(const T&) const;
+	uint32_t siguienteActivo(uint32_t) const;
+	bool pausado(uint32_t) const;
+	void marcarPausado(uint32_t, bool);
+	void reservar(uint32_t);
+
+	// Si hay procesos activos, actual es uno de ellos
+	T* pids;
+	uint32_t capacidad;
+	vector<uint32_t> siguientes;
+	vector<uint32_t> anteriores;
+	vector<uint64_t> pausados;
+	uint32_t actual;
+	uint32_t cantidad;
+	bool planificadorDetenido;
+	// Si la posición i es la i-ésima en orden de ejecución desde la 0
+	bool enOrden;
+	IndiceDeProcesos<T, uint32_t, Hash> indice;
+};
+
+/**
+ * Almacenamiento en estructura de arreglos (ver PlanificadorRRIndexado).
+ */
+struct AlmacenamientoIndexado {};
+
+template<typename T>
+struct PlanificadorSegun<T, AlmacenamientoIndexado> {
+	typedef PlanificadorRRIndexado<T> tipo;
+};
+
+/**
+ * Crea un nuevo planificador de tipo Round Robin.
+ */
+template<class T, class Hash>
+PlanificadorRRIndexado<T, Hash>::PlanificadorRRIndexado(){
+	pids = NULL;
+	capacidad = 0;
+	actual = NINGUNO;
+	cantidad = 0;
+	planificadorDetenido = false;
+	enOrden = true;
+}
+
+/**
+ * Una vez copiado, ambos planificadores son independientes.
+ */
+template<class T, class Hash>
+PlanificadorRRIndexado<T, Hash>::PlanificadorRRIndexado(const PlanificadorRRIndexado<T, Hash>& p):
+	siguientes(p.siguientes), anteriores(p.anteriores), pausados(p.pausados),
+	actual(p.actual), cantidad(p.cantidad), planificadorDetenido(p.planificadorDetenido),
+	enOrden(p.enOrden), indice(p.indice){
+	capacidad = cantidad;
+	pids = static_cast<T*>(::operator new(sizeof(T) * capacidad));
+	for(uint32_t i = 0; i < cantidad; i++){
+		new (&pids[i]) T(p.pids[i]);
+	}
+}
+
+template<class T, class Hash>
+PlanificadorRRIndexado<T, Hash>::~PlanificadorRRIndexado(){
+	for(uint32_t i = 0; i < cantidad; i++){
+		pids[i].~T();
+	}
+	::operator delete(pids);
+}
+
+/**
+ * Agrega un proceso inmediatamente antes del que está siendo ejecutado.
+ * Si no hay ningún proceso en ejecución, pasa a ser ejecutado.
+ * PRE: El proceso no está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::agregarProceso(const T& pid){
+	assert(!esPlanificado(pid));
+	assert(cantidad < NINGUNO);
+	uint32_t nuevo = cantidad;
+	reservar(cantidad + 1);
+	new (&pids[nuevo]) T(pid);
+	siguientes.push_back(nuevo);
+	anteriores.push_back(nuevo);
+	if(pausados.size() * 64 <= nuevo){
+		pausados.push_back(0);
+	}
+	// Va antes que actual: sigue en orden sólo si actual es el primero
+	enOrden = enOrden && (cantidad == 0 || actual == 0);
+	if(cantidad > 0){
+		uint32_t ultimo = anteriores[actual];
+		siguientes[ultimo] = nuevo;
+		anteriores[nuevo] = ultimo;
+		siguientes[nuevo] = actual;
+		anteriores[actual] = nuevo;
+	}
+	if(cantidad == 0 || pausado(actual)){
+		actual = nuevo;
+	}
+	indice.insertar(pids[nuevo], nuevo);
+	cantidad++;
+}
+
+/**
+ * Elimina un proceso. Si estaba en ejecución, pasa a ejecutarse el
+ * siguiente activo (si es que existe). El último proceso de los arreglos
+ * pasa a ocupar la posición liberada.
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::eliminarProceso(const T& p){
+	uint32_t k = posicionDe(p);
+	assert(k != NINGUNO);
+	if(k == actual){
+		uint32_t siguiente = siguienteActivo(k);
+		actual = siguiente != k ? siguiente : siguientes[k];
+	}
+	siguientes[anteriores[k]] = siguientes[k];
+	anteriores[siguientes[k]] = anteriores[k];
+	indice.borrar(pids[k]);
+	pids[k].~T();
+	uint32_t ultimo = cantidad - 1;
+	enOrden = (enOrden && k == ultimo) || cantidad <= 2;
+	if(k != ultimo){
+		new (&pids[k]) T(pids[ultimo]);
+		pids[ultimo].~T();
+		uint32_t siguiente = siguientes[ultimo];
+		uint32_t anterior = anteriores[ultimo];
+		if(siguiente == ultimo){
+			siguiente = k;
+			anterior = k;
+		}
+		siguientes[k] = siguiente;
+		anteriores[k] = anterior;
+		siguientes[anterior] = k;
+		anteriores[siguiente] = k;
+		marcarPausado(k, pausado(ultimo));
+		indice.insertar(pids[k], k);
+		if(actual == ultimo){
+			actual = k;
+		}
+	}
+	marcarPausado(ultimo, false);
+	siguientes.pop_back();
+	anteriores.pop_back();
+	cantidad--;
+	if(cantidad == 0){
+		actual = NINGUNO;
+	}
+}
+
+/**
+ * Devuelve el proceso que está actualmente en ejecución.
+ * PRE: Hay al menos un proceso activo en el planificador.
+ */
+template<class T, class Hash>
+const T& PlanificadorRRIndexado<T, Hash>::procesoEjecutado() const{
+	assert(cantidad > 0);
+	return pids[actual];
+}
+
+/**
+ * Procede a ejecutar el siguiente proceso activo.
+ * PRE: Hay al menos un proceso activo en el planificador.
+ */
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::ejecutarSiguienteProceso(){
+	assert(cantidad > 0 && !pausado(actual));
+	actual = siguienteActivo(actual);
+}
+
+/**
+ * Pausa un proceso. Si estaba en ejecución, pasa a ejecutarse el
+ * siguiente activo (si es que existe).
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está activo.
+ */
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::pausarProceso(const T& p){
+	uint32_t k = posicionDe(p);
+	assert(k != NINGUNO && !pausado(k));
+	if(k == actual){
+		actual = siguienteActivo(k);
+	}
+	marcarPausado(k, true);
+}
+
+/**
+ * Reanuda un proceso pausado. Si no había ningún proceso en ejecución,
+ * pasa a ser ejecutado.
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está inactivo.
+ */
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::reanudarProceso(const T& p){
+	uint32_t k = posicionDe(p);
+	assert(k != NINGUNO && pausado(k));
+	if(pausado(actual)){
+		actual = k;
+	}
+	marcarPausado(k, false);
+}
+
+/**
+ * Detiene la ejecución de todos los procesos.
+ * PRE: El planificador no está detenido.
+ */
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::detener(){
+	assert(!planificadorDetenido);
+	planificadorDetenido = true;
+}
+
+/**
+ * Reanuda la ejecución de los procesos (activos).
+ * PRE: El planificador está detenido.
+ */
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::reanudar(){
+	assert(planificadorDetenido);
+	planificadorDetenido = false;
+}
+
+template<class T, class Hash>
+bool PlanificadorRRIndexado<T, Hash>::detenido() const{
+	return planificadorDetenido;
+}
+
+template<class T, class Hash>
+bool PlanificadorRRIndexado<T, Hash>::esPlanificado(const T& p) const{
+	return posicionDe(p) != NINGUNO;
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+bool PlanificadorRRIndexado<T, Hash>::estaActivo(const T& p) const{
+	uint32_t k = posicionDe(p);
+	assert(k != NINGUNO);
+	return !pausado(k);
+}
+
+template<class T, class Hash>
+bool PlanificadorRRIndexado<T, Hash>::hayProcesos() const{
+	return cantidad > 0;
+}
+
+template<class T, class Hash>
+bool PlanificadorRRIndexado<T, Hash>::hayProcesosActivos() const{
+	return cantidad > 0 && !pausado(actual);
+}
+
+template<class T, class Hash>
+int PlanificadorRRIndexado<T, Hash>::cantidadDeProcesos() const{
+	return cantidad;
+}
+
+/**
+ * Cuenta los bits de pausa de a una palabra de 64 procesos por vez.
+ */
+template<class T, class Hash>
+int PlanificadorRRIndexado<T, Hash>::cantidadDeProcesosActivos() const{
+	return cantidad - (int)contarUnos(pausados.data(), pausados.size());
+}
+
+/**
+ * Reubica los procesos para que las posiciones sigan el orden de
+ * ejecución a partir del actual, que queda en la posición 0. No cambia
+ * el planificador, sólo cómo está guardado.
+ */
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::reordenar(){
+	if(cantidad == 0 || (enOrden && actual == 0)){
+		return;
+	}
+	T* nuevos = static_cast<T*>(::operator new(sizeof(T) * capacidad));
+	vector<uint64_t> nuevosPausados(pausados.size(), 0);
+	uint32_t i = actual;
+	for(uint32_t n = 0; n < cantidad; n++){
+		new (&nuevos[n]) T(pids[i]);
+		if(pausado(i)){
+			nuevosPausados[n >> 6] |= (uint64_t)1 << (n & 63);
+		}
+		indice.insertar(nuevos[n], n);
+		i = siguientes[i];
+	}
+	for(uint32_t n = 0; n < cantidad; n++){
+		pids[n].~T();
+		siguientes[n] = n + 1 < cantidad ? n + 1 : 0;
+		anteriores[n] = n > 0 ? n - 1 : cantidad - 1;
+	}
+	::operator delete(pids);
+	pids = nuevos;
+	pausados.swap(nuevosPausados);
+	actual = 0;
+	enOrden = true;
+}
+
+/**
+ * Devuelve true si las posiciones siguen el orden de ejecución (ver
+ * reordenar).
+ */
+template<class T, class Hash>
+bool PlanificadorRRIndexado<T, Hash>::ordenado() const{
+	return enOrden;
+}
+
+/**
+ * Devuelve true si ambos planificadores son iguales.
+ */
+template<class T, class Hash>
+bool PlanificadorRRIndexado<T, Hash>::operator==(const PlanificadorRRIndexado<T, Hash>& p) const{
+	if(cantidad == 0 && p.cantidad == 0){
+		return true;
+	}
+	if(cantidad != p.cantidad || planificadorDetenido != p.planificadorDetenido){
+		return false;
+	}
+	uint32_t i = actual;
+	uint32_t j = p.actual;
+	for(uint32_t n = 0; n < cantidad; n++){
+		if(!(pids[i] == p.pids[j]) || pausado(i) != p.pausado(j)){
+			return false;
+		}
+		i = siguientes[i];
+		j = p.siguientes[j];
+	}
+	return true;
+}
+
+/**
+ * Muestra los procesos en orden de ejecución con el mismo formato que
+ * PlanificadorRR::mostrarPlanificadorRR.
+ */
+template<class T, class Hash>
+ostream& PlanificadorRRIndexado<T, Hash>::mostrarPlanificadorRR(ostream& os) const{
+	os << "[";
+	uint32_t i = actual;
+	for(uint32_t n = 0; n < cantidad; n++){
+		os << pids[i];
+		if(pausado(i)){
+			os << " (i)";
+		}else if(i == actual){
+			os << "*";
+		}
+		if(n + 1 < cantidad){
+			os << ", ";
+		}
+		i = siguientes[i];
+	}
+	os << "]";
+	return os;
+}
+
+template<class T, class Hash>
+ostream& operator<<(ostream& out, const PlanificadorRRIndexado<T, Hash>& a) {
+	return a.mostrarPlanificadorRR(out);
+}
+
+//Metodos auxiliares
+template<class T, class Hash>
+uint32_t PlanificadorRRIndexado<T, Hash>::posicionDe(const T& p) const{
+	if(indice.habilitado){
+		return indice.buscar(p, NINGUNO);
+	}
+	for(uint32_t i = 0; i < cantidad; i++){
+		if(pids[i] == p){
+			return i;
+		}
+	}
+	return NINGUNO;
+}
+
+/**
+ * Devuelve el primer activo después de i en orden de ejecución, o i
+ * si no hay otro. En orden, es el primer 0 del bitmap de pausados
+ * después de i, dando la vuelta.
+ */
+template<class T, class Hash>
+uint32_t PlanificadorRRIndexado<T, Hash>::siguienteActivo(uint32_t i) const{
+	if(enOrden){
+		size_t j = buscarCero(pausados.data(), i + 1, cantidad);
+		if(j == cantidad){
+			// Si no hay otro activo, da i
+			j = buscarCero(pausados.data(), 0, i);
+		}
+		return (uint32_t)j;
+	}
+	uint32_t j = siguientes[i];
+	while(j != i && pausado(j)){
+		j = siguientes[j];
+	}
+	return j;
+}
+
+template<class T, class Hash>
+bool PlanificadorRRIndexado<T, Hash>::pausado(uint32_t i) const{
+	return (pausados[i >> 6] >> (i & 63)) & 1;
+}
+
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::marcarPausado(uint32_t i, bool valor){
+	uint64_t bit = (uint64_t)1 << (i & 63);
+	if(valor){
+		pausados[i >> 6] |= bit;
+	}else{
+		pausados[i >> 6] &= ~bit;
+	}
+}
+
+/**
+ * Asegura lugar para n pids, duplicando la capacidad si hace falta.
+ */
+template<class T, class Hash>
+void PlanificadorRRIndexado<T, Hash>::reservar(uint32_t n){
+	if(n <= capacidad){
+		return;
+	}
+	uint32_t nuevaCapacidad = capacidad < 8 ? 8 : capacidad;
+	while(nuevaCapacidad < n){
+		nuevaCapacidad *= 2;
+	}
+	T* nuevos = static_cast<T*>(::operator new(sizeof(T) * nuevaCapacidad));
+	for(uint32_t i = 0; i < cantidad; i++){
+		new (&nuevos[i]) T(pids[i]);
+		pids[i].~T();
+	}
+	::operator delete(pids);
+	pids = nuevos;
+	capacidad = nuevaCapacidad;
+}
+
+#endif // PLANIFICADOR_RR_INDEXADO_H_
@@ -0,0 +1,616 @@
+#ifndef PLANIFICADOR_RR_PONDERADO_H_
+#define PLANIFICADOR_RR_PONDERADO_H_
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * Planificador Round Robin ponderado por stride scheduling: cada proceso
+ * tiene un peso y recibe turnos en proporción a él. Cada proceso avanza
+ * una pasada de ZANCADA_BASE / peso por turno y siempre se ejecuta el
+ * activo de menor pasada (a igual pasada, el que llegó antes), así que
+ * elegir el siguiente cuesta O(log n).
+ *
+ * Con todos los pesos iguales el orden de ejecución es el de
+ * PlanificadorRR: un proceso nuevo se ejecuta después de todos los que ya
+ * estaban, y uno reanudado vuelve a su lugar en el anillo, que se
+ * mantiene igual que el de PlanificadorRR. Con pesos distintos, un
+ * proceso reanudado conserva en cambio el adelanto o atraso que tenía
+ * respecto del proceso en ejecución al pausarlo.
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia y operator==
+ * No se puede asumir que el tipo T tenga operator=
+ */
+template<typename T, typename Hash = typename HashPorDefecto<T>::tipo>
+class PlanificadorRRPonderado {
+
+  public:
+
+	static const int PESO_MAXIMO = 1 << 20;
+
+	PlanificadorRRPonderado();
+	PlanificadorRRPonderado(const PlanificadorRRPonderado<T, Hash>&);
+	~PlanificadorRRPonderado();
+	void agregarProceso(const T&, int peso = 1);
+	void eliminarProceso(const T&);
+	void cambiarPeso(const T&, int peso);
+	int pesoDe(const T&) const;
+	const T& procesoEjecutado() const;
+	void ejecutarSiguienteProceso();
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+	void detener();
+	void reanudar();
+	bool detenido() const;
+	bool esPlanificado(const T&) const;
+	bool estaActivo(const T&) const;
+	bool hayProcesos() const;
+	bool hayProcesosActivos() const;
+	int cantidadDeProcesos() const;
+	int cantidadDeProcesosActivos() const;
+	bool operator==(const PlanificadorRRPonderado<T, Hash>&) const;
+	ostream& mostrarPlanificadorRR(ostream&) const;
+
+  private:
+
+	PlanificadorRRPonderado<T, Hash>& operator=(const PlanificadorRRPonderado<T, Hash>& otra) {
+		assert(false);
+		return *this;
+	}
+
+	static const uint64_t ZANCADA_BASE = (uint64_t)PESO_MAXIMO;
+	// Los turnos se numeran salteados para que un reanudado pueda entrar
+	// entre dos turnos seguidos (ver volverASuLugar)
+	static const uint64_t ESPACIO_ENTRE_TURNOS = 1 << 16;
+
+	struct Nodo {
+		T pid;
+		int peso;
+		// Si está activo, su pasada; si está pausado, cuánto le faltaba
+		// respecto de la pasada del que estaba en ejecución.
+		uint64_t pasada;
+		// Desempata pasadas iguales por orden de llegada
+		uint64_t turno;
+		bool pausado;
+		// Anillo de todos los procesos, en el orden del de PlanificadorRR
+		Nodo* siguiente;
+		Nodo* anterior;
+		Nodo(const T& p, int peso): pid(p), peso(peso), pasada(0), turno(0), pausado(false),
+			siguiente(NULL), anterior(NULL){}
+	};
+
+	struct PorPasada {
+		bool operator()(const Nodo* a, const Nodo* b) const {
+			return a->pasada != b->pasada ? a->pasada < b->pasada : a->turno < b->turno;
+		}
+	};
+
+	static uint64_t zancada(int peso);
+	Nodo* dameProceso(const T&) const;
+	uint64_t tiempoActual() const;
+	Nodo* entrada() const;
+	uint64_t nuevoTurno();
+	void renumerarTurnos();
+	void activar(Nodo*, uint64_t pasada);
+	void volverASuLugar(Nodo*);
+	void desactivar(Nodo*);
+	void contarPeso(int, int);
+
+	// El primero de activos es el proceso en ejecución
+	set<Nodo*, PorPasada> activos;
+	// Un proceso del anillo; sin activos, el que sería el actual de
+	// PlanificadorRR (ver entrada)
+	Nodo* primero;
+	int cantidadProcesos;
+	// Cuántos procesos hay de cada peso
+	map<int, int> cantidadPorPeso;
+	// Pasada del último proceso en ejecución, para cuando no hay activos
+	uint64_t tiempoVirtual;
+	uint64_t turnos;
+	bool planificadorDetenido;
+	IndiceDeProcesos<T, Nodo*, Hash> indice;
+};
+
+/**
+ * Crea un nuevo planificador ponderado.
+ */
+template<class T, class Hash>
+PlanificadorRRPonderado<T, Hash>::PlanificadorRRPonderado(){
+	primero = NULL;
+	cantidadProcesos = 0;
+	tiempoVirtual = 0;
+	turnos = 0;
+	planificadorDetenido = false;
+}
+
+/**
+ * Una vez copiado, ambos planificadores son independientes.
+ */
+template<class T, class Hash>
+PlanificadorRRPonderado<T, Hash>::PlanificadorRRPonderado(const PlanificadorRRPonderado<T, Hash>& p){
+	primero = NULL;
+	cantidadProcesos = 0;
+	tiempoVirtual = p.tiempoVirtual;
+	turnos = p.turnos;
+	planificadorDetenido = p.planificadorDetenido;
+	cantidadPorPeso = p.cantidadPorPeso;
+	indice.reservar(p.cantidadProcesos);
+	Nodo* viejo = p.primero;
+	Nodo* ultimo = NULL;
+	for(int i = 0; i < p.cantidadProcesos; i++){
+		Nodo* nuevo = new Nodo(viejo->pid, viejo->peso);
+		nuevo->pasada = viejo->pasada;
+		nuevo->turno = viejo->turno;
+		nuevo->pausado = viejo->pausado;
+		if(ultimo == NULL){
+			primero = nuevo;
+			nuevo->siguiente = nuevo;
+			nuevo->anterior = nuevo;
+		}else{
+			nuevo->anterior = ultimo;
+			nuevo->siguiente = primero;
+			ultimo->siguiente = nuevo;
+			primero->anterior = nuevo;
+		}
+		if(!nuevo->pausado){
+			activos.insert(activos.end(), nuevo);
+		}
+		indice.insertar(nuevo->pid, nuevo);
+		cantidadProcesos++;
+		ultimo = nuevo;
+		viejo = viejo->siguiente;
+	}
+}
+
+template<class T, class Hash>
+PlanificadorRRPonderado<T, Hash>::~PlanificadorRRPonderado(){
+	Nodo* actual = primero;
+	for(int i = 0; i < cantidadProcesos; i++){
+		Nodo* siguiente = actual->siguiente;
+		delete actual;
+		actual = siguiente;
+	}
+}
+
+/**
+ * Agrega un proceso activo con el peso indicado, en el anillo
+ * inmediatamente antes del proceso en ejecución. Su primera pasada es
+ * una zancada después de la del proceso en ejecución, así que con pesos
+ * iguales se ejecuta después de todos los demás. Si no hay ningún
+ * proceso en ejecución, pasa a ser ejecutado.
+ * PRE: El proceso no está siendo planificado por el planificador.
+ * PRE: 1 <= peso <= PESO_MAXIMO
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::agregarProceso(const T& p, int peso){
+	assert(!esPlanificado(p));
+	assert(1 <= peso && peso <= PESO_MAXIMO);
+	Nodo* nuevo = new Nodo(p, peso);
+	if(primero == NULL){
+		primero = nuevo;
+		nuevo->siguiente = nuevo;
+		nuevo->anterior = nuevo;
+	}else{
+		Nodo* actual = entrada();
+		nuevo->anterior = actual->anterior;
+		nuevo->siguiente = actual;
+		actual->anterior->siguiente = nuevo;
+		actual->anterior = nuevo;
+	}
+	indice.insertar(nuevo->pid, nuevo);
+	cantidadProcesos++;
+	contarPeso(peso, 1);
+	activar(nuevo, tiempoActual() + zancada(peso));
+}
+
+/**
+ * Elimina un proceso. Si estaba en ejecución, pasa a ejecutarse el
+ * activo de menor pasada (si es que existe).
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::eliminarProceso(const T& p){
+	Nodo* aEliminar = dameProceso(p);
+	assert(aEliminar != NULL);
+	Nodo* actual = entrada();
+	if(!aEliminar->pausado){
+		desactivar(aEliminar);
+	}
+	if(cantidadProcesos == 1){
+		primero = NULL;
+	}else{
+		// Sin activos, el actual pasa al siguiente del anillo, como en
+		// PlanificadorRR
+		if(activos.empty()){
+			primero = actual;
+		}
+		if(aEliminar == primero){
+			primero = aEliminar->siguiente;
+		}
+		aEliminar->anterior->siguiente = aEliminar->siguiente;
+		aEliminar->siguiente->anterior = aEliminar->anterior;
+	}
+	indice.borrar(aEliminar->pid);
+	contarPeso(aEliminar->peso, -1);
+	delete aEliminar;
+	cantidadProcesos--;
+}
+
+/**
+ * Cambia el peso de un proceso. Lo que le faltaba para su próximo turno
+ * se escala a la nueva zancada, así que el proceso en ejecución sigue
+ * siéndolo.
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: 1 <= peso <= PESO_MAXIMO
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::cambiarPeso(const T& p, int peso){
+	assert(1 <= peso && peso <= PESO_MAXIMO);
+	Nodo* proceso = dameProceso(p);
+	assert(proceso != NULL);
+	uint64_t viejaZancada = zancada(proceso->peso);
+	uint64_t nuevaZancada = zancada(peso);
+	contarPeso(proceso->peso, -1);
+	contarPeso(peso, 1);
+	proceso->peso = peso;
+	if(proceso->pausado){
+		proceso->pasada = proceso->pasada * nuevaZancada / viejaZancada;
+		return;
+	}
+	uint64_t ahora = tiempoActual();
+	uint64_t falta = proceso->pasada - ahora;
+	activos.erase(proceso);
+	proceso->pasada = ahora + falta * nuevaZancada / viejaZancada;
+	activos.insert(proceso);
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+int PlanificadorRRPonderado<T, Hash>::pesoDe(const T& p) const{
+	Nodo* proceso = dameProceso(p);
+	assert(proceso != NULL);
+	return proceso->peso;
+}
+
+/**
+ * Devuelve el proceso que está actualmente en ejecución.
+ * PRE: Hay al menos un proceso activo en el planificador.
+ */
+template<class T, class Hash>
+const T& PlanificadorRRPonderado<T, Hash>::procesoEjecutado() const{
+	assert(!activos.empty());
+	return (*activos.begin())->pid;
+}
+
+/**
+ * Cobra el turno al proceso en ejecución y procede a ejecutar el activo
+ * de menor pasada.
+ * PRE: Hay al menos un proceso activo en el planificador.
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::ejecutarSiguienteProceso(){
+	assert(!activos.empty());
+	Nodo* actual = *activos.begin();
+	activos.erase(activos.begin());
+	actual->pasada += zancada(actual->peso);
+	actual->turno = nuevoTurno();
+	activos.insert(actual);
+	tiempoVirtual = (*activos.begin())->pasada;
+}
+
+/**
+ * Pausa un proceso, recordando cuánto le faltaba para su próximo turno.
+ * Si estaba en ejecución, pasa a ejecutarse el activo de menor pasada
+ * (si es que existe).
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está activo.
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::pausarProceso(const T& p){
+	Nodo* proceso = dameProceso(p);
+	assert(proceso != NULL && !proceso->pausado);
+	uint64_t falta = proceso->pasada - tiempoActual();
+	desactivar(proceso);
+	if(activos.empty()){
+		primero = proceso;
+	}
+	proceso->pasada = falta;
+	proceso->pausado = true;
+}
+
+/**
+ * Reanuda un proceso pausado. Si todos los pesos son iguales, vuelve a
+ * su lugar en el anillo, como en PlanificadorRR; si no, vuelve con lo que
+ * le faltaba para su próximo turno al pausarlo. Si no había ningún
+ * proceso en ejecución, pasa a ser ejecutado.
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está inactivo.
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::reanudarProceso(const T& p){
+	Nodo* proceso = dameProceso(p);
+	assert(proceso != NULL && proceso->pausado);
+	if(!activos.empty() && cantidadPorPeso.size() == 1){
+		volverASuLugar(proceso);
+	}else{
+		activar(proceso, tiempoActual() + proceso->pasada);
+	}
+	proceso->pausado = false;
+}
+
+/**
+ * Detiene la ejecución de todos los procesos.
+ * PRE: El planificador no está detenido.
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::detener(){
+	assert(!planificadorDetenido);
+	planificadorDetenido = true;
+}
+
+/**
+ * Reanuda la ejecución de los procesos (activos).
+ * PRE: El planificador está detenido.
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::reanudar(){
+	assert(planificadorDetenido);
+	planificadorDetenido = false;
+}
+
+template<class T, class Hash>
+bool PlanificadorRRPonderado<T, Hash>::detenido() const{
+	return planificadorDetenido;
+}
+
+template<class T, class Hash>
+bool PlanificadorRRPonderado<T, Hash>::esPlanificado(const T& p) const{
+	return dameProceso(p) != NULL;
+}
+
+/**
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Hash>
+bool PlanificadorRRPonderado<T, Hash>::estaActivo(const T& p) const{
+	Nodo* proceso = dameProceso(p);
+	assert(proceso != NULL);
+	return !proceso->pausado;
+}
+
+template<class T, class Hash>
+bool PlanificadorRRPonderado<T, Hash>::hayProcesos() const{
+	return cantidadProcesos > 0;
+}
+
+template<class T, class Hash>
+bool PlanificadorRRPonderado<T, Hash>::hayProcesosActivos() const{
+	return !activos.empty();
+}
+
+template<class T, class Hash>
+int PlanificadorRRPonderado<T, Hash>::cantidadDeProcesos() const{
+	return cantidadProcesos;
+}
+
+template<class T, class Hash>
+int PlanificadorRRPonderado<T, Hash>::cantidadDeProcesosActivos() const{
+	return (int)activos.size();
+}
+
+/**
+ * Devuelve true si ambos planificadores van a ejecutar los mismos
+ * procesos en el mismo orden, con los mismos pesos y lo mismo pausado.
+ */
+template<class T, class Hash>
+bool PlanificadorRRPonderado<T, Hash>::operator==(const PlanificadorRRPonderado<T, Hash>& p) const{
+	if(cantidadProcesos == 0 && p.cantidadProcesos == 0){
+		return true;
+	}
+	if(cantidadProcesos != p.cantidadProcesos || activos.size() != p.activos.size()
+			|| planificadorDetenido != p.planificadorDetenido){
+		return false;
+	}
+	uint64_t ahora = tiempoActual();
+	uint64_t otroAhora = p.tiempoActual();
+	typename set<Nodo*, PorPasada>::const_iterator it1 = activos.begin();
+	typename set<Nodo*, PorPasada>::const_iterator it2 = p.activos.begin();
+	for(; it1 != activos.end(); ++it1, ++it2){
+		if(!((*it1)->pid == (*it2)->pid) || (*it1)->peso != (*it2)->peso
+				|| (*it1)->pasada - ahora != (*it2)->pasada - otroAhora){
+			return false;
+		}
+	}
+	Nodo* actual = primero;
+	for(int i = 0; i < cantidadProcesos; i++, actual = actual->siguiente){
+		if(!actual->pausado){
+			continue;
+		}
+		Nodo* otro = p.dameProceso(actual->pid);
+		if(otro == NULL || !otro->pausado || otro->peso != actual->peso || otro->pasada != actual->pasada){
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Muestra los procesos activos en el orden de sus próximos turnos y
+ * después los pausados, con el formato de
+ * PlanificadorRR::mostrarPlanificadorRR.
+ */
+template<class T, class Hash>
+ostream& PlanificadorRRPonderado<T, Hash>::mostrarPlanificadorRR(ostream& os) const{
+	os << "[";
+	int restantes = cantidadProcesos;
+	typename set<Nodo*, PorPasada>::const_iterator it = activos.begin();
+	for(; it != activos.end(); ++it){
+		os << (*it)->pid;
+		if(it == activos.begin()){
+			os << "*";
+		}
+		if(--restantes > 0){
+			os << ", ";
+		}
+	}
+	Nodo* actual = primero;
+	for(int i = 0; i < cantidadProcesos; i++, actual = actual->siguiente){
+		if(actual->pausado){
+			os << actual->pid << " (i)";
+			if(--restantes > 0){
+				os << ", ";
+			}
+		}
+	}
+	os << "]";
+	return os;
+}
+
+template<class T, class Hash>
+ostream& operator<<(ostream& out, const PlanificadorRRPonderado<T, Hash>& a) {
+	return a.mostrarPlanificadorRR(out);
+}
+
+//Metodos auxiliares
+template<class T, class Hash>
+uint64_t PlanificadorRRPonderado<T, Hash>::zancada(int peso){
+	return ZANCADA_BASE / (uint64_t)peso;
+}
+
+template<class T, class Hash>
+typename PlanificadorRRPonderado<T, Hash>::Nodo* PlanificadorRRPonderado<T, Hash>::dameProceso(const T& p) const{
+	if(indice.habilitado){
+		return indice.buscar(p, NULL);
+	}
+	Nodo* actual = primero;
+	for(int i = 0; i < cantidadProcesos; i++){
+		if(actual->pid == p){
+			return actual;
+		}
+		actual = actual->siguiente;
+	}
+	return NULL;
+}
+
+/**
+ * Devuelve la pasada del proceso en ejecución, o la del último que se
+ * ejecutó si no hay activos. Nunca decrece.
+ */
+template<class T, class Hash>
+uint64_t PlanificadorRRPonderado<T, Hash>::tiempoActual() const{
+	return activos.empty() ? tiempoVirtual : (*activos.begin())->pasada;
+}
+
+/**
+ * Devuelve el proceso antes del cual entra uno nuevo en el anillo: el
+ * que está en ejecución o, si no hay activos, el que sería el actual de
+ * PlanificadorRR.
+ * PRE: Hay al menos un proceso en el planificador.
+ */
+template<class T, class Hash>
+typename PlanificadorRRPonderado<T, Hash>::Nodo* PlanificadorRRPonderado<T, Hash>::entrada() const{
+	return activos.empty() ? primero : *activos.begin();
+}
+
+template<class T, class Hash>
+uint64_t PlanificadorRRPonderado<T, Hash>::nuevoTurno(){
+	turnos += ESPACIO_ENTRE_TURNOS;
+	return turnos;
+}
+
+/**
+ * Vuelve a numerar los turnos de los activos, en el mismo orden, con el
+ * espacio de siempre entre uno y otro. No cambia el orden del conjunto,
+ * así que se puede hacer sin sacarlos.
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::renumerarTurnos(){
+	typename set<Nodo*, PorPasada>::iterator it = activos.begin();
+	for(; it != activos.end(); ++it){
+		(*it)->turno = nuevoTurno();
+	}
+}
+
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::activar(Nodo* proceso, uint64_t pasada){
+	proceso->pasada = pasada;
+	proceso->turno = nuevoTurno();
+	activos.insert(proceso);
+	tiempoVirtual = (*activos.begin())->pasada;
+}
+
+/**
+ * Activa un proceso pausado en su lugar del anillo: inmediatamente
+ * después del activo que lo precede, es decir, antes del que le sigue a
+ * ese entre los activos (o último, si ese es el actual). Toma la pasada
+ * y un turno entre los de sus vecinos en el orden de ejecución; si los
+ * turnos de los vecinos son seguidos, primero renumera los de todos.
+ * Busca hacia los dos lados del anillo a la vez, como
+ * PlanificadorRR::anteriorActivo.
+ * PRE: Hay al menos un proceso activo y todos los pesos son iguales.
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::volverASuLugar(Nodo* proceso){
+	Nodo* atras = proceso->anterior;
+	Nodo* adelante = proceso->siguiente;
+	while(atras->pausado && adelante->pausado){
+		atras = atras->anterior;
+		adelante = adelante->siguiente;
+	}
+	typename set<Nodo*, PorPasada>::iterator siguiente;
+	if(!atras->pausado){
+		siguiente = activos.find(atras);
+		++siguiente;
+	}else{
+		siguiente = activos.find(adelante);
+	}
+	if(siguiente == activos.begin() || siguiente == activos.end()){
+		// Va último, antes de que le vuelva a tocar al actual
+		proceso->pasada = (*activos.rbegin())->pasada;
+		proceso->turno = nuevoTurno();
+	}else{
+		typename set<Nodo*, PorPasada>::iterator anterior = siguiente;
+		--anterior;
+		Nodo* antes = *anterior;
+		Nodo* despues = *siguiente;
+		if(antes->pasada < despues->pasada){
+			// antes es el último de su pasada
+			proceso->pasada = antes->pasada;
+			proceso->turno = nuevoTurno();
+		}else{
+			if(despues->turno - antes->turno < 2){
+				renumerarTurnos();
+			}
+			proceso->pasada = despues->pasada;
+			proceso->turno = antes->turno + (despues->turno - antes->turno) / 2;
+		}
+	}
+	activos.insert(proceso);
+}
+
+/**
+ * Suma cambio a la cantidad de procesos con el peso indicado.
+ */
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::contarPeso(int peso, int cambio){
+	int& cantidad = cantidadPorPeso[peso];
+	cantidad += cambio;
+	if(cantidad == 0){
+		cantidadPorPeso.erase(peso);
+	}
+}
+
+template<class T, class Hash>
+void PlanificadorRRPonderado<T, Hash>::desactivar(Nodo* proceso){
+	activos.erase(proceso);
+	if(!activos.empty()){
+		tiempoVirtual = (*activos.begin())->pasada;
+	}
+}
+
+#endif // PLANIFICADOR_RR_PONDERADO_H_
@@ -0,0 +1,413 @@
+#ifndef PLANIFICADOR_TEMPORIZADO_H_
+#define PLANIFICADOR_TEMPORIZADO_H_
+
+#include <stdint.h>
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * Planificador con pausas por una cantidad de ticks: pausarPor pausa un
+ * proceso y lo reanuda solo cuando pasan los ticks pedidos (con tick o
+ * avanzarTiempo). Los despertares se guardan en una rueda de tiempos
+ * jerárquica de 4 niveles de 64 ranuras: el nivel 0 tiene una ranura por
+ * tick, y cada nivel siguiente, ranuras 64 veces más largas. Programar un
+ * despertar es O(1) y cada tick cuesta O(1) más los procesos que
+ * despiertan; cada despertar baja de nivel a lo sumo 3 veces antes de
+ * vencer. Los que vencen dentro de más de 2^24 ticks esperan en la última
+ * ranura posible y se vuelven a ubicar cuando llega.
+ *
+ * Sin hash, buscar un despertar (al reanudar o eliminar a mano un
+ * proceso, o con estaDormido) recorre la rueda.
+ *
+ * Planificador es cualquier planificador con la interfaz de PlanificadorRR.
+ *
+ * Se puede asumir que el tipo T tiene constructor por copia y operator==
+ * No se puede asumir que el tipo T tenga operator=
+ */
+template<typename T, typename Planificador = PlanificadorRR<T>,
+	typename Hash = typename HashPorDefecto<T>::tipo>
+class PlanificadorTemporizado {
+
+  public:
+
+	PlanificadorTemporizado();
+	~PlanificadorTemporizado();
+	void agregarProceso(const T&);
+	void eliminarProceso(const T&);
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+	void pausarPor(const T&, uint64_t);
+	void tick();
+	void avanzarTiempo(uint64_t);
+	uint64_t tiempo() const;
+	bool estaDormido(const T&) const;
+	uint64_t ticksParaDespertar(const T&) const;
+	int cantidadDeDormidos() const;
+	const T& procesoEjecutado() const;
+	void ejecutarSiguienteProceso();
+	void detener();
+	void reanudar();
+	const Planificador& planificador() const;
+
+  private:
+
+	PlanificadorTemporizado(const PlanificadorTemporizado<T, Planificador, Hash>&);
+	PlanificadorTemporizado<T, Planificador, Hash>& operator=(const PlanificadorTemporizado<T, Planificador, Hash>&);
+
+	static const int NIVELES = 4;
+	static const int BITS_POR_NIVEL = 6;
+	static const int RANURAS = 1 << BITS_POR_NIVEL;
+
+	/**
+	 * Un despertar programado. siguiente y anterior lo enlazan en el
+	 * anillo de su ranura; ranura es la cabeza de ese anillo, para
+	 * cancelarlo sin buscarla.
+	 */
+	struct Despertar {
+		T pid;
+		uint64_t vence;
+		Despertar* siguiente;
+		Despertar* anterior;
+		Despertar** ranura;
+		Despertar(const T& pid, uint64_t vence): pid(pid), vence(vence),
+			siguiente(NULL), anterior(NULL), ranura(NULL){}
+	};
+
+	void ubicar(Despertar*);
+	uint64_t proximoTickConTrabajo() const;
+	void bajarNivel(int, int);
+	void despertar(int);
+	void cancelar(const T&);
+	Despertar* buscar(const T&) const;
+	static void enlazar(Despertar*&, Despertar*);
+	static void desenlazar(Despertar*&, Despertar*);
+
+	Planificador planificadorInterno;
+	// Primero de cada ranura, o NULL si está vacía
+	Despertar* ranuras[NIVELES][RANURAS];
+	// Ticks transcurridos
+	uint64_t ahora;
+	int cantidadDormidos;
+	IndiceDeProcesos<T, Despertar*, Hash> indice;
+};
+
+template<class T, class Planificador, class Hash>
+PlanificadorTemporizado<T, Planificador, Hash>::PlanificadorTemporizado(){
+	for(int nivel = 0; nivel < NIVELES; nivel++){
+		for(int i = 0; i < RANURAS; i++){
+			ranuras[nivel][i] = NULL;
+		}
+	}
+	ahora = 0;
+	cantidadDormidos = 0;
+}
+
+template<class T, class Planificador, class Hash>
+PlanificadorTemporizado<T, Planificador, Hash>::~PlanificadorTemporizado(){
+	for(int nivel = 0; nivel < NIVELES; nivel++){
+		for(int i = 0; i < RANURAS; i++){
+			while(ranuras[nivel][i] != NULL){
+				Despertar* d = ranuras[nivel][i];
+				desenlazar(ranuras[nivel][i], d);
+				delete d;
+			}
+		}
+	}
+}
+
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::agregarProceso(const T& p){
+	planificadorInterno.agregarProceso(p);
+}
+
+/**
+ * Si el proceso estaba dormido, cancela su despertar.
+ * PRE: El proceso está siendo planificado por el planificador.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::eliminarProceso(const T& p){
+	if(cantidadDormidos > 0){
+		cancelar(p);
+	}
+	planificadorInterno.eliminarProceso(p);
+}
+
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::pausarProceso(const T& p){
+	planificadorInterno.pausarProceso(p);
+}
+
+/**
+ * Si el proceso estaba dormido, se despierta ya y se cancela su despertar.
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está inactivo.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::reanudarProceso(const T& p){
+	if(cantidadDormidos > 0){
+		cancelar(p);
+	}
+	planificadorInterno.reanudarProceso(p);
+}
+
+/**
+ * Pausa el proceso y programa su reanudación para dentro de ticks ticks.
+ * PRE: El proceso está siendo planificado por el planificador.
+ * PRE: El proceso está activo.
+ * PRE: ticks > 0
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::pausarPor(const T& p, uint64_t ticks){
+	assert(ticks > 0);
+	planificadorInterno.pausarProceso(p);
+	Despertar* d = new Despertar(p, ahora + ticks);
+	ubicar(d);
+	indice.insertar(d->pid, d);
+	cantidadDormidos++;
+}
+
+/**
+ * Avanza un tick y reanuda a los procesos que vencen en él.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::tick(){
+	uint64_t t = ahora + 1;
+	int ranura = (int)(t & (RANURAS - 1));
+	// Al completar una vuelta de un nivel se reparte la ranura que le toca
+	// del nivel de arriba
+	for(int nivel = 1; nivel < NIVELES && ranura == 0; nivel++){
+		ranura = (int)((t >> (nivel * BITS_POR_NIVEL)) & (RANURAS - 1));
+		bajarNivel(nivel, ranura);
+	}
+	ahora = t;
+	despertar((int)(t & (RANURAS - 1)));
+}
+
+/**
+ * Avanza dt ticks, con el mismo resultado que llamar dt veces a tick,
+ * pero salta de una vez los ticks en los que no hay nada que despertar
+ * ni bajar de nivel.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::avanzarTiempo(uint64_t dt){
+	uint64_t fin = ahora + dt;
+	while(cantidadDormidos > 0){
+		uint64_t proximo = proximoTickConTrabajo();
+		if(proximo > fin){
+			break;
+		}
+		ahora = proximo - 1;
+		tick();
+	}
+	ahora = fin;
+}
+
+template<class T, class Planificador, class Hash>
+uint64_t PlanificadorTemporizado<T, Planificador, Hash>::tiempo() const{
+	return ahora;
+}
+
+/**
+ * Devuelve true si el proceso está pausado con pausarPor y todavía no
+ * despertó.
+ */
+template<class T, class Planificador, class Hash>
+bool PlanificadorTemporizado<T, Planificador, Hash>::estaDormido(const T& p) const{
+	return buscar(p) != NULL;
+}
+
+/**
+ * PRE: El proceso está dormido.
+ */
+template<class T, class Planificador, class Hash>
+uint64_t PlanificadorTemporizado<T, Planificador, Hash>::ticksParaDespertar(const T& p) const{
+	Despertar* d = buscar(p);
+	assert(d != NULL);
+	return d->vence - ahora;
+}
+
+template<class T, class Planificador, class Hash>
+int PlanificadorTemporizado<T, Planificador, Hash>::cantidadDeDormidos() const{
+	return cantidadDormidos;
+}
+
+template<class T, class Planificador, class Hash>
+const T& PlanificadorTemporizado<T, Planificador, Hash>::procesoEjecutado() const{
+	return planificadorInterno.procesoEjecutado();
+}
+
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::ejecutarSiguienteProceso(){
+	planificadorInterno.ejecutarSiguienteProceso();
+}
+
+/**
+ * Detener el planificador no detiene el tiempo: los dormidos siguen
+ * despertando con tick.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::detener(){
+	planificadorInterno.detener();
+}
+
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::reanudar(){
+	planificadorInterno.reanudar();
+}
+
+template<class T, class Planificador, class Hash>
+const Planificador& PlanificadorTemporizado<T, Planificador, Hash>::planificador() const{
+	return planificadorInterno;
+}
+
+//Metodos auxiliares
+/**
+ * Pone el despertar en la ranura que le corresponde según cuánto falta
+ * desde el próximo tick: en el nivel 0 si vence dentro de los próximos
+ * 64 ticks, en el 1 si vence dentro de los próximos 64^2, y así.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::ubicar(Despertar* d){
+	uint64_t proximo = ahora + 1;
+	uint64_t vence = d->vence < proximo ? proximo : d->vence;
+	uint64_t falta = vence - proximo;
+	int nivel = 0;
+	while(nivel < NIVELES - 1 && falta >> ((nivel + 1) * BITS_POR_NIVEL) != 0){
+		nivel++;
+	}
+	uint64_t maximo = ((uint64_t)1 << (NIVELES * BITS_POR_NIVEL)) - 1;
+	if(falta > maximo){
+		vence = proximo + maximo;
+	}
+	int ranura = (int)((vence >> (nivel * BITS_POR_NIVEL)) & (RANURAS - 1));
+	d->ranura = &ranuras[nivel][ranura];
+	enlazar(*d->ranura, d);
+}
+
+/**
+ * Devuelve el primer tick después de ahora que tiene algo que hacer:
+ * despertar procesos de una ranura del nivel 0 o bajar los de una ranura
+ * de otro nivel. Cada nivel se mira una vuelta entera hacia adelante,
+ * así que a lo sumo lee todas las ranuras una vez.
+ * PRE: Hay al menos un proceso dormido.
+ */
+template<class T, class Planificador, class Hash>
+uint64_t PlanificadorTemporizado<T, Planificador, Hash>::proximoTickConTrabajo() const{
+	uint64_t proximo = UINT64_MAX;
+	for(int nivel = 0; nivel < NIVELES; nivel++){
+		int corrimiento = nivel * BITS_POR_NIVEL;
+		// Las ranuras del nivel se atienden en los ticks múltiplos de 64^nivel
+		uint64_t vuelta = ahora >> corrimiento;
+		for(uint64_t j = 1; j <= (uint64_t)RANURAS; j++){
+			uint64_t t = (vuelta + j) << corrimiento;
+			if(t >= proximo){
+				break;
+			}
+			if(ranuras[nivel][(vuelta + j) & (RANURAS - 1)] != NULL){
+				proximo = t;
+				break;
+			}
+		}
+	}
+	assert(proximo != UINT64_MAX);
+	return proximo;
+}
+
+/**
+ * Reubica los despertares de una ranura de un nivel superior, que ahora
+ * vencen más cerca.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::bajarNivel(int nivel, int ranura){
+	Despertar* pendientes = ranuras[nivel][ranura];
+	ranuras[nivel][ranura] = NULL;
+	while(pendientes != NULL){
+		Despertar* d = pendientes;
+		desenlazar(pendientes, d);
+		ubicar(d);
+	}
+}
+
+/**
+ * Reanuda los procesos de la ranura del nivel 0, que vencen ahora.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::despertar(int ranura){
+	Despertar*& vencidos = ranuras[0][ranura];
+	while(vencidos != NULL){
+		Despertar* d = vencidos;
+		desenlazar(vencidos, d);
+		assert(d->vence == ahora);
+		indice.borrar(d->pid);
+		cantidadDormidos--;
+		planificadorInterno.reanudarProceso(d->pid);
+		delete d;
+	}
+}
+
+/**
+ * Si el proceso está dormido, saca su despertar de la rueda.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::cancelar(const T& p){
+	Despertar* d = buscar(p);
+	if(d == NULL){
+		return;
+	}
+	desenlazar(*d->ranura, d);
+	indice.borrar(d->pid);
+	cantidadDormidos--;
+	delete d;
+}
+
+template<class T, class Planificador, class Hash>
+typename PlanificadorTemporizado<T, Planificador, Hash>::Despertar* PlanificadorTemporizado<T, Planificador, Hash>::buscar(const T& p) const{
+	if(indice.habilitado){
+		return indice.buscar(p, NULL);
+	}
+	for(int nivel = 0; nivel < NIVELES; nivel++){
+		for(int i = 0; i < RANURAS; i++){
+			Despertar* d = ranuras[nivel][i];
+			for(bool primero = true; d != NULL && (primero || d != ranuras[nivel][i]); primero = false){
+				if(d->pid == p){
+					return d;
+				}
+				d = d->siguiente;
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Enlaza n al final del anillo que empieza en cabeza.
+ */
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::enlazar(Despertar*& cabeza, Despertar* n){
+	if(cabeza == NULL){
+		cabeza = n;
+		n->siguiente = n;
+		n->anterior = n;
+		return;
+	}
+	Despertar* ultimo = cabeza->anterior;
+	n->siguiente = cabeza;
+	n->anterior = ultimo;
+	ultimo->siguiente = n;
+	cabeza->anterior = n;
+}
+
+template<class T, class Planificador, class Hash>
+void PlanificadorTemporizado<T, Planificador, Hash>::desenlazar(Despertar*& cabeza, Despertar* n){
+	if(n->siguiente == n){
+		cabeza = NULL;
+		return;
+	}
+	n->anterior->siguiente = n->siguiente;
+	n->siguiente->anterior = n->anterior;
+	if(cabeza == n){
+		cabeza = n->siguiente;
+	}
+}
+
+#endif // PLANIFICADOR_TEMPORIZADO_H_
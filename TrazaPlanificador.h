@@ -0,0 +1,431 @@
+#ifndef TRAZA_PLANIFICADOR_H_
+#define TRAZA_PLANIFICADOR_H_
+
+#include <cassert>
+#include <cstring>
+#include <ostream>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+#include "PlanificadorRR.h"
+using namespace std;
+
+/**
+ * Formato de las trazas: la cabecera "PRRT" seguida de la versión, y
+ * después una operación por registro. Cada registro empieza con un byte
+ * de código; los que llevan proceso siguen con el pid en varint zigzag
+ * (1 byte para pids chicos). Las ejecuciones seguidas se guardan juntas,
+ * como un único registro con la cantidad. El registro TRAZA_FIN cierra la
+ * traza con el estado final: la cantidad de procesos, si está detenido,
+ * y cada proceso en orden de ejecución a partir del actual con su byte
+ * de pausado.
+ */
+enum CodigoDeTraza {
+	TRAZA_AGREGAR = 1,
+	TRAZA_ELIMINAR,
+	TRAZA_PAUSAR,
+	TRAZA_REANUDAR,
+	TRAZA_EJECUTAR,
+	TRAZA_DETENER,
+	TRAZA_REANUDAR_PLANIFICADOR,
+	TRAZA_FIN
+};
+
+static const char CABECERA_DE_TRAZA[4] = {'P', 'R', 'R', 'T'};
+static const unsigned char VERSION_DE_TRAZA = 1;
+static const size_t LARGO_DE_CABECERA = sizeof(CABECERA_DE_TRAZA) + 1;
+
+/**
+ * Escribe registros de traza en un ostream, a través de un buffer propio
+ * para no pagar una llamada al stream por operación.
+ */
+class EscritorDeTraza {
+
+  public:
+
+	static const size_t TAMANIO_DE_BUFFER = 1 << 16;
+
+	explicit EscritorDeTraza(ostream& salida): salida(salida) {
+		buffer.reserve(TAMANIO_DE_BUFFER);
+		buffer.insert(buffer.end(), CABECERA_DE_TRAZA, CABECERA_DE_TRAZA + sizeof(CABECERA_DE_TRAZA));
+		buffer.push_back(VERSION_DE_TRAZA);
+	}
+
+	~EscritorDeTraza() { vaciarBuffer(); }
+
+	void escribirCodigo(CodigoDeTraza codigo) {
+		asegurarLugar();
+		buffer.push_back((unsigned char)codigo);
+	}
+
+	void escribirByte(unsigned char b) {
+		asegurarLugar();
+		buffer.push_back(b);
+	}
+
+	void escribirVarint(uint64_t v) {
+		asegurarLugar();
+		while(v >= 0x80){
+			buffer.push_back((unsigned char)(v | 0x80));
+			v >>= 7;
+		}
+		buffer.push_back((unsigned char)v);
+	}
+
+	void escribirPid(int64_t pid) {
+		escribirVarint(((uint64_t)pid << 1) ^ (uint64_t)(pid >> 63));
+	}
+
+	void vaciarBuffer() {
+		if(!buffer.empty()){
+			salida.write((const char*)&buffer[0], buffer.size());
+			buffer.clear();
+		}
+		salida.flush();
+	}
+
+  private:
+
+	EscritorDeTraza(const EscritorDeTraza&);
+	EscritorDeTraza& operator=(const EscritorDeTraza&);
+
+	// Un registro ocupa a lo sumo un código y un varint de 10 bytes
+	void asegurarLugar() {
+		if(buffer.size() + 11 > TAMANIO_DE_BUFFER){
+			salida.write((const char*)&buffer[0], buffer.size());
+			buffer.clear();
+		}
+	}
+
+	ostream& salida;
+	vector<unsigned char> buffer;
+};
+
+/**
+ * Lee registros de una traza que ya está entera en memoria. Nunca lee
+ * fuera de [datos, fin): una traza cortada (por ejemplo, si el proceso
+ * que la grababa terminó mal) se lee hasta el último registro completo.
+ */
+class LectorDeTraza {
+
+  public:
+
+	LectorDeTraza(const unsigned char* datos, size_t largo): actual(datos), fin(datos + largo) {}
+
+	bool cabeceraValida() {
+		if(fin - actual < (ptrdiff_t)LARGO_DE_CABECERA
+				|| memcmp(actual, CABECERA_DE_TRAZA, sizeof(CABECERA_DE_TRAZA)) != 0
+				|| actual[sizeof(CABECERA_DE_TRAZA)] != VERSION_DE_TRAZA){
+			return false;
+		}
+		actual += LARGO_DE_CABECERA;
+		return true;
+	}
+
+	bool leerByte(unsigned char& b) {
+		if(actual == fin){
+			return false;
+		}
+		b = *actual++;
+		return true;
+	}
+
+	bool leerVarint(uint64_t& v) {
+		v = 0;
+		for(int corrimiento = 0; actual != fin && corrimiento < 64; corrimiento += 7){
+			unsigned char b = *actual++;
+			v |= (uint64_t)(b & 0x7F) << corrimiento;
+			if(b < 0x80){
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool leerPid(int64_t& pid) {
+		uint64_t v;
+		if(!leerVarint(v)){
+			return false;
+		}
+		pid = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+		return true;
+	}
+
+	const unsigned char* posicion() const { return actual; }
+
+  private:
+
+	const unsigned char* actual;
+	const unsigned char* fin;
+};
+
+/**
+ * Planificador que graba en una traza cada operación que recibe, para
+ * reproducirla después con reproducirTraza. Sin salida se comporta igual
+ * que Planificador y no graba nada.
+ *
+ * Los pids tienen que ser enteros. Planificador es cualquier planificador
+ * con la interfaz de PlanificadorRR, incluido recorrerProcesos para poder
+ * guardar el estado final.
+ */
+template<typename T, typename Planificador = PlanificadorRR<T> >
+class PlanificadorRegistrado {
+
+	static_assert(is_integral<T>::value, "las trazas guardan pids enteros");
+
+  public:
+
+	explicit PlanificadorRegistrado(ostream* salida = NULL);
+	~PlanificadorRegistrado();
+	void agregarProceso(const T&);
+	void eliminarProceso(const T&);
+	void pausarProceso(const T&);
+	void reanudarProceso(const T&);
+	void ejecutarSiguienteProceso();
+	void detener();
+	void reanudar();
+	void terminarTraza();
+	const Planificador& planificador() const;
+
+  private:
+
+	PlanificadorRegistrado(const PlanificadorRegistrado<T, Planificador>&);
+	PlanificadorRegistrado<T, Planificador>& operator=(const PlanificadorRegistrado<T, Planificador>&);
+
+	void registrar(CodigoDeTraza);
+	void registrar(CodigoDeTraza, const T&);
+
+	Planificador planificadorInterno;
+	EscritorDeTraza* escritor;
+	// Ejecuciones todavía no escritas, para guardarlas en un solo registro
+	uint64_t ejecucionesPendientes;
+};
+
+template<class T, class Planificador>
+PlanificadorRegistrado<T, Planificador>::PlanificadorRegistrado(ostream* salida){
+	escritor = salida == NULL ? NULL : new EscritorDeTraza(*salida);
+	ejecucionesPendientes = 0;
+}
+
+/**
+ * Si la traza sigue abierta, la cierra con el estado final.
+ */
+template<class T, class Planificador>
+PlanificadorRegistrado<T, Planificador>::~PlanificadorRegistrado(){
+	terminarTraza();
+}
+
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::agregarProceso(const T& pid){
+	registrar(TRAZA_AGREGAR, pid);
+	planificadorInterno.agregarProceso(pid);
+}
+
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::eliminarProceso(const T& pid){
+	registrar(TRAZA_ELIMINAR, pid);
+	planificadorInterno.eliminarProceso(pid);
+}
+
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::pausarProceso(const T& pid){
+	registrar(TRAZA_PAUSAR, pid);
+	planificadorInterno.pausarProceso(pid);
+}
+
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::reanudarProceso(const T& pid){
+	registrar(TRAZA_REANUDAR, pid);
+	planificadorInterno.reanudarProceso(pid);
+}
+
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::ejecutarSiguienteProceso(){
+	if(escritor != NULL){
+		ejecucionesPendientes++;
+	}
+	planificadorInterno.ejecutarSiguienteProceso();
+}
+
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::detener(){
+	registrar(TRAZA_DETENER);
+	planificadorInterno.detener();
+}
+
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::reanudar(){
+	registrar(TRAZA_REANUDAR_PLANIFICADOR);
+	planificadorInterno.reanudar();
+}
+
+/**
+ * Cierra la traza con el estado actual del planificador y la escribe
+ * entera en la salida. Las operaciones siguientes ya no se graban.
+ */
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::terminarTraza(){
+	if(escritor == NULL){
+		return;
+	}
+	registrar(TRAZA_FIN);
+	EscritorDeTraza& e = *escritor;
+	e.escribirVarint(planificadorInterno.cantidadDeProcesos());
+	e.escribirByte(planificadorInterno.detenido());
+	planificadorInterno.recorrerProcesos([&e](const T& pid, bool pausado){
+		e.escribirPid((int64_t)pid);
+		e.escribirByte(pausado);
+	});
+	delete escritor;
+	escritor = NULL;
+}
+
+template<class T, class Planificador>
+const Planificador& PlanificadorRegistrado<T, Planificador>::planificador() const{
+	return planificadorInterno;
+}
+
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::registrar(CodigoDeTraza codigo){
+	if(escritor == NULL){
+		return;
+	}
+	if(ejecucionesPendientes > 0){
+		escritor->escribirCodigo(TRAZA_EJECUTAR);
+		escritor->escribirVarint(ejecucionesPendientes);
+		ejecucionesPendientes = 0;
+	}
+	escritor->escribirCodigo(codigo);
+}
+
+template<class T, class Planificador>
+void PlanificadorRegistrado<T, Planificador>::registrar(CodigoDeTraza codigo, const T& pid){
+	if(escritor == NULL){
+		return;
+	}
+	registrar(codigo);
+	escritor->escribirPid((int64_t)pid);
+}
+
+/**
+ * Resultado de reproducir una traza. estadoFinal apunta al estado final
+ * guardado en la traza, o es NULL si la traza no llegó a cerrarse.
+ */
+struct ResultadoDeReproduccion {
+	bool cabeceraValida;
+	long operaciones;
+	const unsigned char* estadoFinal;
+	const unsigned char* fin;
+};
+
+/**
+ * Aplica al planificador, en orden, todas las operaciones de la traza de
+ * largo bytes que empieza en datos. Cada ejecución cuenta como una
+ * operación. Si la traza está cortada, aplica los registros completos.
+ * PRE: Aplicadas a un planificador vacío, las operaciones de la traza
+ * cumplen las precondiciones de Planificador.
+ */
+template<typename Planificador>
+ResultadoDeReproduccion reproducirTraza(const unsigned char* datos, size_t largo, Planificador& planificador) {
+	ResultadoDeReproduccion resultado = {false, 0, NULL, datos + largo};
+	LectorDeTraza lector(datos, largo);
+	if(!lector.cabeceraValida()){
+		return resultado;
+	}
+	resultado.cabeceraValida = true;
+	unsigned char codigo;
+	int64_t pid;
+	uint64_t veces;
+	while(lector.leerByte(codigo)){
+		switch(codigo){
+		case TRAZA_AGREGAR:
+			if(!lector.leerPid(pid)) return resultado;
+			planificador.agregarProceso(pid);
+			break;
+		case TRAZA_ELIMINAR:
+			if(!lector.leerPid(pid)) return resultado;
+			planificador.eliminarProceso(pid);
+			break;
+		case TRAZA_PAUSAR:
+			if(!lector.leerPid(pid)) return resultado;
+			planificador.pausarProceso(pid);
+			break;
+		case TRAZA_REANUDAR:
+			if(!lector.leerPid(pid)) return resultado;
+			planificador.reanudarProceso(pid);
+			break;
+		case TRAZA_EJECUTAR:
+			if(!lector.leerVarint(veces)) return resultado;
+			for(uint64_t i = 0; i < veces; i++){
+				planificador.ejecutarSiguienteProceso();
+			}
+			resultado.operaciones += veces - 1;
+			break;
+		case TRAZA_DETENER:
+			planificador.detener();
+			break;
+		case TRAZA_REANUDAR_PLANIFICADOR:
+			planificador.reanudar();
+			break;
+		case TRAZA_FIN:
+			resultado.estadoFinal = lector.posicion();
+			return resultado;
+		default:
+			// Código desconocido: el resto de la traza no se puede leer
+			return resultado;
+		}
+		resultado.operaciones++;
+	}
+	return resultado;
+}
+
+/**
+ * Arma, con las operaciones públicas de Planificador, el estado final
+ * guardado en la traza, y lo compara con operator== contra planificador.
+ * Devuelve false si la traza no tiene estado final o está cortada.
+ */
+template<typename Planificador>
+bool coincideConEstadoFinal(const ResultadoDeReproduccion& resultado, const Planificador& planificador) {
+	if(resultado.estadoFinal == NULL){
+		return false;
+	}
+	LectorDeTraza lector(resultado.estadoFinal, resultado.fin - resultado.estadoFinal);
+	uint64_t cantidad;
+	unsigned char detenido;
+	if(!lector.leerVarint(cantidad) || !lector.leerByte(detenido)){
+		return false;
+	}
+	// El primero agregado queda como actual y los demás detrás, en orden
+	vector<int64_t> pausados;
+	int64_t primero = 0;
+	bool primeroPausado = false;
+	Planificador esperado;
+	for(uint64_t i = 0; i < cantidad; i++){
+		int64_t pid;
+		unsigned char pausado;
+		if(!lector.leerPid(pid) || !lector.leerByte(pausado)){
+			return false;
+		}
+		esperado.agregarProceso(pid);
+		if(i == 0){
+			primero = pid;
+			primeroPausado = pausado;
+		}else if(pausado){
+			pausados.push_back(pid);
+		}
+	}
+	for(size_t i = 0; i < pausados.size(); i++){
+		esperado.pausarProceso(pausados[i]);
+	}
+	// El actual sólo está pausado si lo están todos: pausarlo al final
+	// no lo cambia de lugar
+	if(primeroPausado){
+		esperado.pausarProceso(primero);
+	}
+	if(detenido){
+		esperado.detener();
+	}
+	return esperado == planificador;
+}
+
+#endif // TRAZA_PLANIFICADOR_H_
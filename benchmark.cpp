@@ -0,0 +1,339 @@
+// g++ -O2 -std=c++17 benchmark.cpp -o benchmark
+// ./benchmark [--max n] [--tiempo ms] > resultados.json
+// ./benchmark --comparar viejo.json nuevo.json [tolerancia]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "PlanificadorRR.h"
+
+using namespace std;
+
+/**
+ * Proceso con una carga de 128 bytes, para medir lo que cuesta copiar y
+ * mover pids que no entran en un registro.
+ */
+struct Pesado {
+    int id;
+    char carga[124];
+    Pesado(int id): id(id) { memset(carga, id & 0xFF, sizeof(carga)); }
+    bool operator==(const Pesado& otro) const { return id == otro.id; }
+};
+
+ostream& operator<<(ostream& os, const Pesado& p) {
+    return os << p.id;
+}
+
+namespace std {
+template<>
+struct hash<Pesado> {
+    size_t operator()(const Pesado& p) const { return hash<int>()(p.id); }
+};
+}
+
+typedef chrono::steady_clock Reloj;
+
+struct Medicion {
+    double nanosegundos;
+    long operaciones;
+    Medicion(): nanosegundos(0), operaciones(0) {}
+};
+
+/**
+ * Acumula el tiempo de cada operación a lo largo de varias rondas.
+ */
+class Cronometro {
+
+  public:
+
+    void empezar() { inicio = Reloj::now(); }
+
+    void terminar(const string& operacion, long operaciones) {
+        Medicion& m = mediciones[operacion];
+        m.nanosegundos += chrono::duration<double, nano>(Reloj::now() - inicio).count();
+        m.operaciones += operaciones;
+    }
+
+    const map<string, Medicion>& resultados() const { return mediciones; }
+
+  private:
+
+    Reloj::time_point inicio;
+    map<string, Medicion> mediciones;
+};
+
+// Evita que el compilador descarte resultados que no se usan
+volatile long sumidero;
+
+/**
+ * Una ronda completa sobre un planificador de n procesos, con la
+ * fracción indicada de procesos pausados durante las operaciones que
+ * no cambian el estado.
+ */
+template<typename T>
+void ronda(int n, double fraccionPausados, mt19937& azar, Cronometro& cronometro) {
+    vector<int> pids(n);
+    for (int i = 0; i < n; i++) {
+        pids[i] = i;
+    }
+    shuffle(pids.begin(), pids.end(), azar);
+    int pausados = (int)(n * fraccionPausados);
+    if (pausados == n) {
+        pausados = n - 1;
+    }
+    long suma = 0;
+
+    PlanificadorRR<T>* planificador = new PlanificadorRR<T>();
+    cronometro.empezar();
+    for (int i = 0; i < n; i++) {
+        planificador->agregarProceso(T(pids[i]));
+    }
+    cronometro.terminar("agregarProceso", n);
+
+    cronometro.empezar();
+    for (int i = 0; i < pausados; i++) {
+        planificador->pausarProceso(T(pids[i]));
+    }
+    cronometro.terminar("pausarProceso", pausados);
+
+    long pasos = max(n, 100000);
+    cronometro.empezar();
+    for (long i = 0; i < pasos; i++) {
+        planificador->ejecutarSiguienteProceso();
+    }
+    cronometro.terminar("ejecutarSiguienteProceso", pasos);
+
+    cronometro.empezar();
+    for (int i = 0; i < 1000; i++) {
+        planificador->ejecutarSiguientes(n / 3 + i);
+    }
+    cronometro.terminar("ejecutarSiguientes", 1000);
+
+    vector<T> proximos;
+    proximos.reserve(64);
+    cronometro.empezar();
+    for (int i = 0; i < 1000; i++) {
+        proximos.clear();
+        planificador->proximosProcesos(64, back_inserter(proximos));
+    }
+    cronometro.terminar("proximosProcesos", 1000);
+
+    cronometro.empezar();
+    for (int i = 0; i < n; i++) {
+        suma += planificador->esPlanificado(T(pids[i]));
+        suma += planificador->esPlanificado(T(n + pids[i]));
+    }
+    cronometro.terminar("esPlanificado", 2L * n);
+
+    cronometro.empezar();
+    for (int i = 0; i < n; i++) {
+        suma += planificador->estaActivo(T(pids[i]));
+    }
+    cronometro.terminar("estaActivo", n);
+
+    cronometro.empezar();
+    for (int i = 0; i < 1000; i++) {
+        suma += planificador->cantidadDeProcesosActivos() + planificador->hayProcesosActivos();
+        suma += planificador->procesoEjecutado() == T(pids[0]);
+    }
+    cronometro.terminar("consultas", 1000);
+
+    cronometro.empezar();
+    suma += planificador->huella();
+    cronometro.terminar("huella", 1);
+
+    cronometro.empezar();
+    PlanificadorRR<T>* copia = new PlanificadorRR<T>(*planificador);
+    cronometro.terminar("copia", 1);
+
+    // La primera modificación de la copia es la que copia los nodos
+    cronometro.empezar();
+    copia->pausarProceso(T(pids[n - 1]));
+    copia->reanudarProceso(T(pids[n - 1]));
+    cronometro.terminar("copia+escritura", 1);
+
+    cronometro.empezar();
+    suma += *copia == *planificador;
+    cronometro.terminar("operator==", 1);
+
+    cronometro.empezar();
+    delete copia;
+    cronometro.terminar("destructor", 1);
+
+    ostringstream salida;
+    cronometro.empezar();
+    planificador->mostrarPlanificadorRR(salida);
+    cronometro.terminar("mostrarPlanificadorRR", 1);
+    suma += salida.str().size();
+
+    cronometro.empezar();
+    planificador->reubicarEnOrden();
+    cronometro.terminar("reubicarEnOrden", 1);
+
+    cronometro.empezar();
+    for (int i = 0; i < pausados; i++) {
+        planificador->reanudarProceso(T(pids[i]));
+    }
+    cronometro.terminar("reanudarProceso", pausados);
+
+    int alterno = 0;
+    cronometro.empezar();
+    planificador->pausarSi([&alterno](const T&) { return (alterno++ & 1) == 0; });
+    planificador->reanudarSi([](const T&) { return true; });
+    cronometro.terminar("pausarSi+reanudarSi", 1);
+
+    shuffle(pids.begin(), pids.end(), azar);
+    cronometro.empezar();
+    for (int i = 0; i < n; i++) {
+        planificador->eliminarProceso(T(pids[i]));
+    }
+    cronometro.terminar("eliminarProceso", n);
+    delete planificador;
+
+    vector<T> masivos;
+    masivos.reserve(n);
+    for (int i = 0; i < n; i++) {
+        masivos.push_back(T(pids[i]));
+    }
+    planificador = new PlanificadorRR<T>();
+    cronometro.empezar();
+    planificador->agregarProcesos(masivos.begin(), masivos.end());
+    cronometro.terminar("agregarProcesos", n);
+
+    cronometro.empezar();
+    planificador->eliminarProcesos(masivos.begin(), masivos.begin() + n / 2);
+    cronometro.terminar("eliminarProcesos", n / 2);
+
+    cronometro.empezar();
+    planificador->vaciar();
+    cronometro.terminar("vaciar", 1);
+    delete planificador;
+
+    sumidero = suma;
+}
+
+/**
+ * Repite rondas hasta juntar el tiempo mínimo y escribe un resultado
+ * por operación, uno por línea.
+ */
+template<typename T>
+void medir(const char* tipo, int n, double fraccionPausados, double milisegundos, bool& primero) {
+    mt19937 azar(n);
+    Cronometro cronometro;
+    Reloj::time_point inicio = Reloj::now();
+    int rondas = 0;
+    do {
+        ronda<T>(n, fraccionPausados, azar, cronometro);
+        rondas++;
+    } while (chrono::duration<double, milli>(Reloj::now() - inicio).count() < milisegundos);
+
+    const map<string, Medicion>& resultados = cronometro.resultados();
+    for (map<string, Medicion>::const_iterator it = resultados.begin(); it != resultados.end(); ++it) {
+        if (it->second.operaciones == 0) {
+            continue;
+        }
+        printf("%s  {\"tipo\": \"%s\", \"n\": %d, \"pausados\": %.2f, \"operacion\": \"%s\", "
+            "\"ns_por_op\": %.2f, \"rondas\": %d}",
+            primero ? "" : ",\n", tipo, n, fraccionPausados, it->first.c_str(),
+            it->second.nanosegundos / it->second.operaciones, rondas);
+        primero = false;
+    }
+    fflush(stdout);
+}
+
+struct Resultado {
+    string clave;
+    double nsPorOp;
+};
+
+/**
+ * Lee un archivo escrito por este mismo programa: un resultado por línea.
+ */
+vector<Resultado> leer(const char* archivo) {
+    vector<Resultado> resultados;
+    ifstream entrada(archivo);
+    string linea;
+    while (getline(entrada, linea)) {
+        char tipo[32], operacion[64];
+        int n;
+        double pausados, nsPorOp;
+        const char* objeto = strchr(linea.c_str(), '{');
+        if (objeto == NULL || sscanf(objeto,
+                "{\"tipo\": \"%31[^\"]\", \"n\": %d, \"pausados\": %lf, \"operacion\": \"%63[^\"]\", \"ns_por_op\": %lf",
+                tipo, &n, &pausados, operacion, &nsPorOp) != 5) {
+            continue;
+        }
+        char clave[160];
+        snprintf(clave, sizeof(clave), "%s n=%d pausados=%.2f %s", tipo, n, pausados, operacion);
+        Resultado r = {clave, nsPorOp};
+        resultados.push_back(r);
+    }
+    return resultados;
+}
+
+/**
+ * Marca las operaciones que en el archivo nuevo tardan más que en el
+ * viejo por encima de la tolerancia. Devuelve la cantidad de regresiones.
+ */
+int comparar(const char* viejo, const char* nuevo, double tolerancia) {
+    vector<Resultado> antes = leer(viejo);
+    vector<Resultado> despues = leer(nuevo);
+    map<string, double> porClave;
+    for (size_t i = 0; i < antes.size(); i++) {
+        porClave[antes[i].clave] = antes[i].nsPorOp;
+    }
+    int regresiones = 0;
+    for (size_t i = 0; i < despues.size(); i++) {
+        map<string, double>::const_iterator it = porClave.find(despues[i].clave);
+        if (it == porClave.end() || it->second <= 0) {
+            continue;
+        }
+        double razon = despues[i].nsPorOp / it->second;
+        if (razon > 1 + tolerancia) {
+            printf("REGRESION %-60s %12.2f -> %12.2f ns/op (x%.2f)\n", despues[i].clave.c_str(),
+                it->second, despues[i].nsPorOp, razon);
+            regresiones++;
+        } else if (razon < 1 / (1 + tolerancia)) {
+            printf("mejora    %-60s %12.2f -> %12.2f ns/op (x%.2f)\n", despues[i].clave.c_str(),
+                it->second, despues[i].nsPorOp, razon);
+        }
+    }
+    printf("%d regresiones sobre %d mediciones (tolerancia %.0f%%)\n", regresiones, (int)despues.size(),
+        tolerancia * 100);
+    return regresiones;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && strcmp(argv[1], "--comparar") == 0) {
+        double tolerancia = argc > 4 ? atof(argv[4]) : 0.25;
+        return comparar(argv[2], argv[3], tolerancia) > 0 ? 1 : 0;
+    }
+    int maximo = 1000000;
+    double milisegundos = 200;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--max") == 0) {
+            maximo = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--tiempo") == 0) {
+            milisegundos = atof(argv[i + 1]);
+        }
+    }
+    const double mezclas[] = {0.0, 0.5, 0.9};
+    bool primero = true;
+    printf("{\"resultados\": [\n");
+    for (int n = 10; n <= maximo; n *= 10) {
+        for (int m = 0; m < 3; m++) {
+            medir<int>("int", n, mezclas[m], milisegundos, primero);
+            medir<Pesado>("pesado", n, mezclas[m], milisegundos, primero);
+        }
+    }
+    printf("\n]}\n");
+    return 0;
+}
@@ -0,0 +1,68 @@
+// g++ -O2 -pthread benchmark_multicore.cpp -o benchmark_multicore
+// ./benchmark_multicore [hilosMaximos] [despachosPorHilo] [procesosPorHilo]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "PlanificadorMulticore.h"
+
+using namespace std;
+
+/**
+ * Despacha con un hilo por trabajador y devuelve los despachos por
+ * segundo. Si desbalanceado, todos los procesos empiezan en el
+ * trabajador 0 y el resto tiene que robarlos.
+ */
+double medir(int hilos, long despachosPorHilo, int procesosPorHilo, bool desbalanceado, long& robos) {
+    PlanificadorMulticore<int> multi(hilos);
+    for (int i = 0; i < hilos * procesosPorHilo; i++) {
+        if (desbalanceado) {
+            multi.agregarProceso(i, 0);
+        } else {
+            multi.agregarProceso(i);
+        }
+    }
+    vector<thread> trabajadores;
+    vector<long> sumas(hilos, 0);
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    for (int h = 0; h < hilos; h++) {
+        trabajadores.push_back(thread([&multi, &sumas, h, despachosPorHilo]() {
+            long suma = 0;
+            for (long i = 0; i < despachosPorHilo; i++) {
+                multi.ejecutarSiguienteProceso(h, [&suma](const int& pid) { suma += pid; });
+            }
+            sumas[h] = suma;
+        }));
+    }
+    for (int h = 0; h < hilos; h++) {
+        trabajadores[h].join();
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    robos = multi.cantidadDeRobos();
+    return hilos * despachosPorHilo / segundos;
+}
+
+int main(int argc, char** argv) {
+    int hilosMaximos = argc > 1 ? atoi(argv[1]) : (int)thread::hardware_concurrency();
+    long despachosPorHilo = argc > 2 ? atol(argv[2]) : 2000000;
+    int procesosPorHilo = argc > 3 ? atoi(argv[3]) : 1000;
+    if (hilosMaximos < 1) {
+        hilosMaximos = 1;
+    }
+    printf("%6s %16s %10s %16s %10s %10s\n", "hilos", "balanceado/s", "escala", "desbalanceado/s", "escala", "robos");
+    double base = 0, baseDesbalanceado = 0;
+    for (int hilos = 1; hilos <= hilosMaximos; hilos++) {
+        long robos = 0, robosDesbalanceado = 0;
+        double balanceado = medir(hilos, despachosPorHilo, procesosPorHilo, false, robos);
+        double desbalanceado = medir(hilos, despachosPorHilo, procesosPorHilo, true, robosDesbalanceado);
+        if (hilos == 1) {
+            base = balanceado;
+            baseDesbalanceado = desbalanceado;
+        }
+        printf("%6d %16.0f %9.2fx %16.0f %9.2fx %10ld\n", hilos, balanceado, balanceado / base,
+            desbalanceado, desbalanceado / baseDesbalanceado, robosDesbalanceado);
+    }
+    return 0;
+}
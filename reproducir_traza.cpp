@@ -0,0 +1,158 @@
+// g++ -O2 -std=c++17 reproducir_traza.cpp -o reproducir_traza
+// ./reproducir_traza traza.bin [enlazado|pool|sinhash|estadisticas|indexado] [repeticiones]
+// ./reproducir_traza --generar traza.bin [procesos] [operaciones] [semilla]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <random>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "PlanificadorRR.h"
+#include "PlanificadorRRIndexado.h"
+#include "AsignadorPool.h"
+#include "TrazaPlanificador.h"
+
+using namespace std;
+
+/**
+ * Reproduce la traza repeticiones veces, cada vez sobre un planificador
+ * nuevo, y muestra cuántas operaciones por segundo aplicó. El estado final
+ * se compara aparte, fuera del tiempo medido.
+ */
+template<typename Planificador>
+int reproducir(const char* nombre, const unsigned char* datos, size_t largo, int repeticiones) {
+    double mejor = 0;
+    ResultadoDeReproduccion resultado = {false, 0, NULL, NULL};
+    bool coincide = true;
+    for (int r = 0; r < repeticiones; r++) {
+        Planificador* planificador = new Planificador();
+        chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+        resultado = reproducirTraza(datos, largo, *planificador);
+        double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (!resultado.cabeceraValida) {
+            fprintf(stderr, "la cabecera de la traza no es valida\n");
+            delete planificador;
+            return 2;
+        }
+        if (segundos > 0 && resultado.operaciones / segundos > mejor) {
+            mejor = resultado.operaciones / segundos;
+        }
+        coincide = coincide && coincideConEstadoFinal(resultado, *planificador);
+        delete planificador;
+    }
+    printf("%-12s %12ld operaciones %14.0f op/s  estado final: %s\n", nombre, resultado.operaciones, mejor,
+        resultado.estadoFinal == NULL ? "no grabado" : coincide ? "coincide" : "DISTINTO");
+    return resultado.estadoFinal != NULL && !coincide ? 1 : 0;
+}
+
+/**
+ * Graba una traza sintética: agrega procesos hasta tener la cantidad
+ * pedida y después mezcla ejecuciones (la mayoría) con altas, bajas,
+ * pausas, reanudaciones y alguna interrupción.
+ */
+void generar(const char* archivo, int procesos, long operaciones, unsigned semilla) {
+    ofstream salida(archivo, ios::binary);
+    PlanificadorRegistrado<int> registrado(&salida);
+    mt19937 azar(semilla);
+    vector<int> planificados;
+    int siguientePid = 0;
+    for (int i = 0; i < procesos; i++) {
+        registrado.agregarProceso(siguientePid);
+        planificados.push_back(siguientePid++);
+    }
+    for (long i = 0; i < operaciones; i++) {
+        int dado = azar() % 100;
+        if (dado < 80 || planificados.empty()) {
+            if (registrado.planificador().hayProcesosActivos()) {
+                registrado.ejecutarSiguienteProceso();
+            } else if (!planificados.empty()) {
+                registrado.reanudarProceso(planificados[azar() % planificados.size()]);
+            } else {
+                registrado.agregarProceso(siguientePid);
+                planificados.push_back(siguientePid++);
+            }
+            continue;
+        }
+        size_t elegido = azar() % planificados.size();
+        int pid = planificados[elegido];
+        if (dado < 85) {
+            registrado.agregarProceso(siguientePid);
+            planificados.push_back(siguientePid++);
+        } else if (dado < 90) {
+            registrado.eliminarProceso(pid);
+            planificados[elegido] = planificados.back();
+            planificados.pop_back();
+        } else if (dado < 99) {
+            if (registrado.planificador().estaActivo(pid)) {
+                registrado.pausarProceso(pid);
+            } else {
+                registrado.reanudarProceso(pid);
+            }
+        } else if (registrado.planificador().detenido()) {
+            registrado.reanudar();
+        } else {
+            registrado.detener();
+        }
+    }
+    registrado.terminarTraza();
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "--generar") == 0) {
+        int procesos = argc > 3 ? atoi(argv[3]) : 1000;
+        long operaciones = argc > 4 ? atol(argv[4]) : 10000000;
+        unsigned semilla = argc > 5 ? (unsigned)atoi(argv[5]) : 1;
+        generar(argv[2], procesos, operaciones, semilla);
+        return 0;
+    }
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s traza.bin [configuracion] [repeticiones]\n", argv[0]);
+        return 2;
+    }
+    const char* configuracion = argc > 2 ? argv[2] : "todas";
+    int repeticiones = argc > 3 ? atoi(argv[3]) : 3;
+
+    int descriptor = open(argv[1], O_RDONLY);
+    struct stat estado;
+    if (descriptor < 0 || fstat(descriptor, &estado) != 0 || estado.st_size == 0) {
+        perror(argv[1]);
+        return 2;
+    }
+    size_t largo = estado.st_size;
+    void* mapa = mmap(NULL, largo, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapa == MAP_FAILED) {
+        perror("mmap");
+        return 2;
+    }
+    // La traza se lee una sola vez de principio a fin
+    madvise(mapa, largo, MADV_SEQUENTIAL);
+    const unsigned char* datos = (const unsigned char*)mapa;
+
+    bool todas = strcmp(configuracion, "todas") == 0;
+    int error = 0;
+    if (todas || strcmp(configuracion, "enlazado") == 0) {
+        error |= reproducir<PlanificadorRR<int> >("enlazado", datos, largo, repeticiones);
+    }
+    if (todas || strcmp(configuracion, "pool") == 0) {
+        error |= reproducir<PlanificadorRR<int, hash<int>, AsignadorPool<int> > >("pool", datos, largo, repeticiones);
+    }
+    if (todas || strcmp(configuracion, "sinhash") == 0) {
+        error |= reproducir<PlanificadorRR<int, SinHash> >("sinhash", datos, largo, repeticiones);
+    }
+    if (todas || strcmp(configuracion, "estadisticas") == 0) {
+        error |= reproducir<PlanificadorRR<int, hash<int>, allocator<int>, EstadisticasAtomicas> >(
+            "estadisticas", datos, largo, repeticiones);
+    }
+    if (todas || strcmp(configuracion, "indexado") == 0) {
+        error |= reproducir<PlanificadorRRIndexado<int> >("indexado", datos, largo, repeticiones);
+    }
+    munmap(mapa, largo);
+    return error;
+}
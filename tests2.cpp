@@ -1,9 +1,25 @@
-// g++ -g tests.cpp -o tests
-// valgrind --leak-check=full -v ./tests
+// g++ -g -pthread tests2.cpp -o tests2
+// valgrind --leak-check=full -v ./tests2
 
 #include <algorithm>
+#include <map>
+#include <set>
+#include <unordered_set>
+#include <vector>
 #include "mini_test.h"
 #include "PlanificadorRR.h"
+#include "PlanificadorRRIndexado.h"
+#include "PlanificadorRRDenso.h"
+#include "PlanificadorRRPonderado.h"
+#include "PlanificadorMultinivel.h"
+#include "PlanificadorPorGrupos.h"
+#include "PlanificadorTemporizado.h"
+#include "PlanificadorConcurrente.h"
+#include "PlanificadorMulticore.h"
+#include "TrazaPlanificador.h"
+#include "EventosPlanificador.h"
+#include "InstantaneaPlanificador.h"
+#include <thread>
 
 using namespace std;
 
@@ -229,12 +245,1502 @@ void restricted() {
 
 }
 
+/**
+ * Con hash<int> disponible las búsquedas usan el índice.
+ */
+void indicePorPid() {
+    PlanificadorRR<int> planificador;
+    for (int i = 0; i < 1000; i++) {
+        planificador.agregarProceso(i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        planificador.pausarProceso(i);
+    }
+    ASSERT_EQ(planificador.esPlanificado(999), true);
+    ASSERT_EQ(planificador.esPlanificado(1000), false);
+    ASSERT_EQ(planificador.estaActivo(998), false);
+    ASSERT_EQ(planificador.estaActivo(997), true);
+    ASSERT_EQ(planificador.cantidadDeProcesosActivos(), 500);
+    for (int i = 0; i < 1000; i += 3) {
+        planificador.eliminarProceso(i);
+    }
+    ASSERT_EQ(planificador.esPlanificado(0), false);
+    ASSERT_EQ(planificador.esPlanificado(1), true);
+    ASSERT_EQ(planificador.cantidadDeProcesos(), 666);
+    planificador.reanudarProceso(2);
+    ASSERT_EQ(planificador.estaActivo(2), true);
+    planificador.agregarProceso(0);
+    ASSERT_EQ(planificador.esPlanificado(0), true);
+}
+
+/**
+ * Con la mayoría de los procesos pausados, el orden de ejecución y el
+ * lugar de cada proceso reanudado se mantienen.
+ */
+void mayoriaPausados() {
+    PlanificadorRR<int> planificador;
+    for (int i = 0; i < 8; i++) {
+        planificador.agregarProceso(i);
+    }
+    for (int i = 0; i < 8; i++) {
+        if (i != 2 && i != 6) {
+            planificador.pausarProceso(i);
+        }
+    }
+    ASSERT_EQ(planificador.cantidadDeProcesosActivos(), 2);
+    ASSERT_EQ(to_s(planificador), "[2*, 3 (i), 4 (i), 5 (i), 6, 7 (i), 0 (i), 1 (i)]");
+    planificador.ejecutarSiguienteProceso();
+    ASSERT_EQ(planificador.procesoEjecutado(), 6);
+    planificador.reanudarProceso(4);
+    planificador.ejecutarSiguienteProceso();
+    ASSERT_EQ(planificador.procesoEjecutado(), 2);
+    planificador.ejecutarSiguienteProceso();
+    ASSERT_EQ(planificador.procesoEjecutado(), 4);
+    planificador.pausarProceso(4);
+    ASSERT_EQ(planificador.procesoEjecutado(), 6);
+    planificador.pausarProceso(2);
+    planificador.pausarProceso(6);
+    ASSERT_EQ(planificador.hayProcesosActivos(), false);
+    planificador.reanudarProceso(0);
+    ASSERT_EQ(to_s(planificador), "[0*, 1 (i), 2 (i), 3 (i), 4 (i), 5 (i), 6 (i), 7 (i)]");
+}
+
+/**
+ * Con AsignadorPool, reubicarEnOrden deja los nodos contiguos en orden
+ * de ejecución sin cambiar el estado.
+ */
+void poolReubicado() {
+    typedef PlanificadorRR<int, hash<int>, AsignadorPool<int> > PlanificadorPool;
+    PlanificadorPool planificador;
+    for (int i = 0; i < 6; i++) {
+        planificador.agregarProceso(i);
+    }
+    planificador.eliminarProceso(2);
+    planificador.agregarProceso(2);
+    planificador.pausarProceso(4);
+    planificador.ejecutarSiguienteProceso();
+    PlanificadorPool copia(planificador);
+    string antes = to_s(planificador);
+
+    planificador.reubicarEnOrden();
+    ASSERT_EQ(to_s(planificador), antes);
+    ASSERT(planificador == copia);
+
+    planificador.reanudarProceso(4);
+    const int* anterior = &planificador.procesoEjecutado();
+    for (int i = 1; i < 6; i++) {
+        planificador.ejecutarSiguienteProceso();
+        const int* actual = &planificador.procesoEjecutado();
+        ASSERT(actual > anterior);
+        anterior = actual;
+    }
+
+    // Una copia que se separa usa otra arena: no reusa lo que libera el
+    // original
+    PlanificadorPool original;
+    original.agregarProceso(1);
+    original.agregarProceso(2);
+    PlanificadorPool separada(original);
+    separada.eliminarProceso(2);
+    separada.eliminarProceso(1);
+    const int* liberado = &original.procesoEjecutado();
+    original.eliminarProceso(1);
+    separada.agregarProceso(3);
+    ASSERT(&separada.procesoEjecutado() != liberado);
+
+    // Los planificadores creados con el mismo asignador comparten el pool
+    AsignadorPool<int> pool;
+    PlanificadorPool uno(pool);
+    PlanificadorPool otro(pool);
+    uno.agregarProceso(1);
+    liberado = &uno.procesoEjecutado();
+    uno.eliminarProceso(1);
+    otro.agregarProceso(2);
+    ASSERT(&otro.procesoEjecutado() == liberado);
+}
+
+/**
+ * El almacenamiento indexado se comporta igual que el enlazado.
+ */
+void almacenamientoIndexado() {
+    PlanificadorSegun<int, AlmacenamientoIndexado>::tipo planificador;
+    planificador.agregarProceso(0);
+    planificador.pausarProceso(0);
+    planificador.agregarProceso(1);
+    planificador.agregarProceso(2);
+    planificador.agregarProceso(3);
+    planificador.pausarProceso(2);
+    ASSERT_EQ(to_s(planificador), "[1*, 0 (i), 2 (i), 3]");
+    ASSERT_EQ(planificador.cantidadDeProcesosActivos(), 2);
+
+    PlanificadorSegun<int, AlmacenamientoIndexado>::tipo copia(planificador);
+    ASSERT(planificador == copia);
+    copia.ejecutarSiguienteProceso();
+    copia.agregarProceso(4);
+    planificador.eliminarProceso(1);
+    ASSERT_EQ(to_s(planificador), "[3*, 0 (i), 2 (i)]");
+    ASSERT_EQ(to_s(copia), "[3*, 1, 0 (i), 2 (i), 4]");
+    ASSERT(!(planificador == copia));
+
+    NoAsignableNiConstruiblePorDefecto p0(0), p1(1), p2(2);
+    PlanificadorRRIndexado<NoAsignableNiConstruiblePorDefecto> restringido;
+    restringido.agregarProceso(p0);
+    restringido.agregarProceso(p1);
+    restringido.agregarProceso(p2);
+    restringido.pausarProceso(p1);
+    restringido.eliminarProceso(p0);
+    ASSERT_EQ(to_s(restringido), "[2*, 1 (i)]");
+    ASSERT_EQ(restringido.esPlanificado(p0), false);
+    ASSERT_EQ(restringido.estaActivo(p2), true);
+}
+
+bool esPar(int x) {
+    return x % 2 == 0;
+}
+
+/**
+ * Las operaciones masivas dan lo mismo que las individuales.
+ */
+void operacionesMasivas() {
+    PlanificadorRR<int> uno;
+    for (int i = 0; i < 6; i++) {
+        uno.agregarProceso(i);
+    }
+    PlanificadorRR<int> masivo = {0, 1, 2, 3, 4, 5};
+    ASSERT(uno == masivo);
+
+    vector<int> mas;
+    mas.push_back(6);
+    mas.push_back(7);
+    masivo.agregarProcesos(mas.begin(), mas.end());
+    uno.agregarProceso(6);
+    uno.agregarProceso(7);
+    ASSERT(uno == masivo);
+    ASSERT_EQ(to_s(masivo), "[0*, 1, 2, 3, 4, 5, 6, 7]");
+
+    masivo.pausarSi(esPar);
+    ASSERT_EQ(to_s(masivo), "[1*, 2 (i), 3, 4 (i), 5, 6 (i), 7, 0 (i)]");
+    ASSERT_EQ(masivo.cantidadDeProcesosActivos(), 4);
+    masivo.eliminarProcesos(mas.begin(), mas.end());
+    ASSERT_EQ(to_s(masivo), "[1*, 2 (i), 3, 4 (i), 5, 0 (i)]");
+    masivo.pausarSi(esPar);
+    masivo.reanudarSi(esPar);
+    ASSERT_EQ(to_s(masivo), "[1*, 2, 3, 4, 5, 0]");
+
+    PlanificadorRR<int, hash<int>, AsignadorPool<int> > pool(mas.begin(), mas.end());
+    ASSERT_EQ(to_s(pool), "[6*, 7]");
+    pool.vaciar();
+    ASSERT_EQ(pool.hayProcesos(), false);
+    ASSERT_EQ(pool.esPlanificado(6), false);
+    pool.agregarProceso(6);
+    ASSERT_EQ(to_s(pool), "[6*]");
+}
+
+/**
+ * La copia comparte los nodos hasta que alguna de las dos se modifica.
+ */
+void copiaCompartida() {
+    PlanificadorRR<int> original = {0, 1, 2, 3};
+    PlanificadorRR<int> copia(original);
+    ASSERT(&copia.procesoEjecutado() == &original.procesoEjecutado());
+
+    copia.ejecutarSiguienteProceso();
+    ASSERT_EQ(copia.procesoEjecutado(), 1);
+    ASSERT_EQ(original.procesoEjecutado(), 0);
+    const int* compartido = &copia.procesoEjecutado();
+
+    copia.pausarProceso(2);
+    ASSERT(&copia.procesoEjecutado() != compartido);
+    ASSERT_EQ(to_s(copia), "[1*, 2 (i), 3, 0]");
+    ASSERT_EQ(to_s(original), "[0*, 1, 2, 3]");
+    original.ejecutarSiguienteProceso();
+    ASSERT(&original.procesoEjecutado() == compartido);
+
+    PlanificadorRR<int> otra(original);
+    original.vaciar();
+    ASSERT_EQ(to_s(original), "[]");
+    ASSERT_EQ(to_s(otra), "[1*, 2, 3, 0]");
+    ASSERT_EQ(otra.esPlanificado(3), true);
+}
+
+PlanificadorRR<NoAsignableNiConstruiblePorDefecto> crearRestringido(int n) {
+    PlanificadorRR<NoAsignableNiConstruiblePorDefecto> planificador;
+    for (int i = 0; i < n; i++) {
+        planificador.emplaceProceso(i);
+    }
+    return planificador;
+}
+
+/**
+ * Los planificadores se pueden mover, aunque T no tenga operator=.
+ */
+void movimientos() {
+    PlanificadorRR<NoAsignableNiConstruiblePorDefecto> planificador = crearRestringido(3);
+    ASSERT_EQ(to_s(planificador), "[0*, 1, 2]");
+    planificador.agregarProceso(NoAsignableNiConstruiblePorDefecto(3));
+    ASSERT_EQ(to_s(planificador), "[0*, 1, 2, 3]");
+
+    PlanificadorRR<NoAsignableNiConstruiblePorDefecto> movido(std::move(planificador));
+    ASSERT_EQ(to_s(movido), "[0*, 1, 2, 3]");
+    ASSERT_EQ(to_s(planificador), "[]");
+    planificador.emplaceProceso(7);
+    ASSERT_EQ(to_s(planificador), "[7*]");
+
+    movido.detener();
+    planificador = std::move(movido);
+    ASSERT_EQ(to_s(planificador), "[0*, 1, 2, 3]");
+    ASSERT(planificador.detenido());
+    ASSERT(!movido.detenido());
+    ASSERT_EQ(movido.hayProcesos(), false);
+
+    vector<PlanificadorRR<int> > planificadores;
+    for (int i = 0; i < 10; i++) {
+        planificadores.push_back(PlanificadorRR<int>());
+        planificadores.back().agregarProceso(i);
+    }
+    ASSERT_EQ(to_s(planificadores[0]), "[0*]");
+    ASSERT_EQ(to_s(planificadores[9]), "[9*]");
+}
+
+/**
+ * Planificadores iguales tienen la misma huella, aunque se hayan armado
+ * por caminos distintos, y se pueden guardar en un unordered_set.
+ */
+void huellaDeEstado() {
+    PlanificadorRR<int> armado = {0, 1, 2, 3};
+    PlanificadorRR<int> otro = {2, 3, 0, 1};
+    ASSERT(!(armado == otro));
+    otro.ejecutarSiguienteProceso();
+    otro.ejecutarSiguienteProceso();
+    ASSERT(armado == otro);
+    ASSERT(armado.huella() == otro.huella());
+
+    PlanificadorRR<int> desordenado = {0, 2, 1, 3};
+    ASSERT(!(armado == desordenado));
+    ASSERT(armado.huella() != desordenado.huella());
+
+    otro.pausarProceso(2);
+    ASSERT(!(armado == otro));
+    ASSERT(armado.huella() != otro.huella());
+    otro.reanudarProceso(2);
+    ASSERT(armado == otro);
+    ASSERT(armado.huella() == otro.huella());
+
+    otro.eliminarProceso(3);
+    otro.agregarProceso(3);
+    ASSERT_EQ(to_s(otro), "[0*, 1, 2, 3]");
+    ASSERT(armado.huella() == otro.huella());
+
+    otro.detener();
+    ASSERT(!(armado == otro));
+    ASSERT(armado.huella() != otro.huella());
+
+    unordered_set<PlanificadorRR<int> > vistos;
+    vistos.insert(armado);
+    vistos.insert(desordenado);
+    vistos.insert(PlanificadorRR<int>(armado));
+    ASSERT_EQ((int)vistos.size(), 2);
+    ASSERT_EQ((int)vistos.count(PlanificadorRR<int>({3, 0, 2, 1})), 0);
+    ASSERT_EQ((int)vistos.count(PlanificadorRR<int>({0, 2, 1, 3})), 1);
+}
+
+/**
+ * Con pesos iguales se ejecuta en el mismo orden que PlanificadorRR; con
+ * pesos distintos cada proceso recibe turnos en proporción a su peso.
+ */
+void ponderado() {
+    PlanificadorRR<int> comun;
+    PlanificadorRRPonderado<int> parejo;
+    for (int i = 0; i < 5; i++) {
+        comun.agregarProceso(i);
+        parejo.agregarProceso(i);
+    }
+    for (int i = 0; i < 12; i++) {
+        if (i == 3) {
+            comun.agregarProceso(7);
+            parejo.agregarProceso(7);
+        }
+        if (i == 6) {
+            comun.eliminarProceso(2);
+            parejo.eliminarProceso(2);
+            comun.pausarProceso(4);
+            parejo.pausarProceso(4);
+        }
+        ASSERT_EQ(parejo.procesoEjecutado(), comun.procesoEjecutado());
+        comun.ejecutarSiguienteProceso();
+        parejo.ejecutarSiguienteProceso();
+    }
+    ASSERT_EQ(to_s(parejo), "[3*, 0, 1, 7, 4 (i)]");
+
+    PlanificadorRRPonderado<int> pesado;
+    pesado.agregarProceso(1, 4);
+    pesado.agregarProceso(2);
+    pesado.agregarProceso(3, 2);
+    int turnos[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 70; i++) {
+        turnos[pesado.procesoEjecutado()]++;
+        pesado.ejecutarSiguienteProceso();
+    }
+    ASSERT_EQ(turnos[1], 40);
+    ASSERT_EQ(turnos[2], 10);
+    ASSERT_EQ(turnos[3], 20);
+
+    pesado.cambiarPeso(2, 4);
+    ASSERT_EQ(pesado.pesoDe(2), 4);
+    pesado.pausarProceso(3);
+    pesado.pausarProceso(1);
+    ASSERT_EQ(pesado.cantidadDeProcesosActivos(), 1);
+    ASSERT_EQ(pesado.procesoEjecutado(), 2);
+    pesado.reanudarProceso(1);
+    pesado.reanudarProceso(3);
+    turnos[1] = turnos[2] = turnos[3] = 0;
+    for (int i = 0; i < 100; i++) {
+        turnos[pesado.procesoEjecutado()]++;
+        pesado.ejecutarSiguienteProceso();
+    }
+    ASSERT(turnos[1] >= 39 && turnos[1] <= 41);
+    ASSERT(turnos[2] >= 39 && turnos[2] <= 41);
+    ASSERT(turnos[3] >= 19 && turnos[3] <= 21);
+
+    PlanificadorRRPonderado<int> copia(pesado);
+    ASSERT(copia == pesado);
+    copia.ejecutarSiguienteProceso();
+    ASSERT(!(copia == pesado));
+
+    // Con pesos iguales, también pausando y reanudando, el orden es el
+    // de PlanificadorRR
+    PlanificadorRR<int> referencia;
+    PlanificadorRRPonderado<int> iguales;
+    unsigned azar = 777;
+    for (int i = 0; i < 20000; i++) {
+        azar = azar * 1103515245 + 12345;
+        int pid = (azar >> 8) % 40;
+        int operacion = (azar >> 20) % 4;
+        if (!referencia.esPlanificado(pid)) {
+            referencia.agregarProceso(pid);
+            iguales.agregarProceso(pid, 3);
+        } else if (operacion == 0) {
+            referencia.eliminarProceso(pid);
+            iguales.eliminarProceso(pid);
+        } else if (operacion == 1 && referencia.hayProcesosActivos()) {
+            referencia.ejecutarSiguienteProceso();
+            iguales.ejecutarSiguienteProceso();
+        } else if (referencia.estaActivo(pid)) {
+            referencia.pausarProceso(pid);
+            iguales.pausarProceso(pid);
+        } else {
+            referencia.reanudarProceso(pid);
+            iguales.reanudarProceso(pid);
+        }
+        ASSERT_EQ(iguales.cantidadDeProcesosActivos(), referencia.cantidadDeProcesosActivos());
+        if (i % 97 == 0 && referencia.hayProcesosActivos()) {
+            PlanificadorRR<int> vueltaReferencia(referencia);
+            PlanificadorRRPonderado<int> vuelta(iguales);
+            for (int k = 0; k <= referencia.cantidadDeProcesosActivos(); k++) {
+                ASSERT_EQ(vuelta.procesoEjecutado(), vueltaReferencia.procesoEjecutado());
+                vuelta.ejecutarSiguienteProceso();
+                vueltaReferencia.ejecutarSiguienteProceso();
+            }
+        }
+    }
+}
+
+/**
+ * Se ejecuta siempre el nivel más prioritario con procesos activos; los
+ * procesos degradados esperan hasta que se vacía el nivel de arriba o
+ * hasta el próximo impulso.
+ */
+void multinivel() {
+    PlanificadorMultinivel<int, 4> planificador;
+    planificador.agregarProceso(1);
+    planificador.agregarProceso(2);
+    planificador.agregarProceso(3, 2);
+    ASSERT_EQ(planificador.procesoEjecutado(), 1);
+    planificador.ejecutarSiguienteProceso();
+    ASSERT_EQ(planificador.procesoEjecutado(), 2);
+    planificador.ejecutarSiguienteProceso();
+    ASSERT_EQ(planificador.procesoEjecutado(), 1);
+
+    planificador.degradar(planificador.procesoEjecutado());
+    ASSERT_EQ(planificador.nivelDe(1), 1);
+    ASSERT_EQ(planificador.procesoEjecutado(), 2);
+    planificador.pausarProceso(2);
+    ASSERT_EQ(planificador.nivelEjecutado(), 1);
+    ASSERT_EQ(planificador.procesoEjecutado(), 1);
+    planificador.eliminarProceso(1);
+    ASSERT_EQ(planificador.procesoEjecutado(), 3);
+    ASSERT_EQ(to_s(planificador), "{0: [2 (i)], 2: [3*]}");
+
+    planificador.agregarProceso(4, 3);
+    planificador.degradar(3);
+    planificador.degradar(3);
+    ASSERT_EQ(planificador.nivelDe(3), 3);
+    ASSERT_EQ(to_s(planificador), "{0: [2 (i)], 3: [4*, 3]}");
+    planificador.reanudarProceso(2);
+    ASSERT_EQ(planificador.procesoEjecutado(), 2);
+    ASSERT_EQ(planificador.cantidadDeProcesosActivos(), 3);
+
+    planificador.pausarProceso(4);
+    planificador.impulsar();
+    ASSERT_EQ(planificador.nivelDe(3), 0);
+    ASSERT_EQ(planificador.nivelDe(4), 0);
+    ASSERT_EQ(to_s(planificador), "{0: [2*, 3, 4 (i)]}");
+    planificador.cambiarNivel(2, 1);
+    ASSERT_EQ(planificador.procesoEjecutado(), 3);
+    ASSERT_EQ(planificador.nivelDe(2), 1);
+
+    planificador.detener();
+    PlanificadorMultinivel<int, 4> copia(planificador);
+    ASSERT(copia == planificador);
+    copia.pausarProceso(3);
+    ASSERT(!(copia == planificador));
+    ASSERT_EQ(copia.procesoEjecutado(), 2);
+    ASSERT(copia.detenido());
+}
+
+/**
+ * Varios hilos piden cambios mientras el hilo del planificador despacha;
+ * al final todos los pedidos quedaron aplicados en orden por productor.
+ */
+void pedidosConcurrentes() {
+    PlanificadorConcurrente<int> concurrente;
+    const int hilos = 4;
+    const int porHilo = 2000;
+    vector<thread> productores;
+    for (int h = 0; h < hilos; h++) {
+        productores.push_back(thread([&concurrente, h]() {
+            for (int i = 0; i < porHilo; i++) {
+                int pid = h * porHilo + i;
+                concurrente.pedirAgregar(pid);
+                if (i % 2 == 1) {
+                    concurrente.pedirPausar(pid);
+                }
+                if (i % 4 == 3) {
+                    concurrente.pedirEliminar(pid);
+                }
+            }
+        }));
+    }
+    int despachos = 0;
+    while (concurrente.planificador().cantidadDeProcesos() < hilos * porHilo / 2 && despachos < 10000000) {
+        concurrente.ejecutarSiguienteProceso();
+        despachos++;
+    }
+    for (int h = 0; h < hilos; h++) {
+        productores[h].join();
+    }
+    concurrente.aplicarPedidos();
+    PlanificadorRR<int>& planificador = concurrente.planificador();
+    ASSERT_EQ(planificador.cantidadDeProcesos(), hilos * porHilo * 3 / 4);
+    ASSERT_EQ(planificador.cantidadDeProcesosActivos(), hilos * porHilo / 2);
+    ASSERT_EQ(planificador.esPlanificado(porHilo + 3), false);
+    ASSERT_EQ(planificador.estaActivo(porHilo + 5), false);
+    ASSERT_EQ(planificador.estaActivo(porHilo + 4), true);
+    ASSERT_EQ(concurrente.pedidosDescartados(), 0);
+
+    concurrente.pedirReanudar(porHilo + 4);
+    concurrente.pedirEliminar(porHilo + 3);
+    concurrente.pedirReanudar(porHilo + 5);
+    ASSERT_EQ(concurrente.aplicarPedidos(2), 2);
+    ASSERT_EQ(concurrente.pedidosDescartados(), 2);
+    ASSERT_EQ(planificador.estaActivo(porHilo + 5), false);
+    concurrente.ejecutarSiguienteProceso();
+    ASSERT_EQ(planificador.estaActivo(porHilo + 5), true);
+}
+
+/**
+ * Todos los procesos empiezan en un trabajador y los demás se los roban;
+ * las operaciones globales siguen encontrando a cada proceso.
+ */
+void multicore() {
+    const int trabajadores = 4;
+    PlanificadorMulticore<int> multi(trabajadores);
+    for (int i = 0; i < 200; i++) {
+        multi.agregarProceso(i, 0);
+    }
+    vector<thread> hilos;
+    vector<int> despachados(trabajadores, 0);
+    for (int h = 0; h < trabajadores; h++) {
+        hilos.push_back(thread([&multi, &despachados, h]() {
+            int ultimo = -1;
+            // El ladrón puede encontrar ocupada a la víctima en todos los
+            // intentos; sigue hasta despachar algo
+            for (int i = 0; i < 5000 || despachados[h] == 0; i++) {
+                if (multi.ejecutarSiguienteProceso(h, [&ultimo](const int& pid) { ultimo = pid; })) {
+                    despachados[h]++;
+                }
+            }
+        }));
+    }
+    for (int i = 0; i < 200; i += 10) {
+        multi.pausarProceso(i);
+        ASSERT_EQ(multi.estaActivo(i), false);
+    }
+    for (int h = 0; h < trabajadores; h++) {
+        hilos[h].join();
+    }
+    ASSERT(multi.cantidadDeRobos() > 0);
+    for (int h = 0; h < trabajadores; h++) {
+        ASSERT(despachados[h] > 0);
+    }
+    ASSERT_EQ(multi.cantidadDeProcesos(), 200);
+    ASSERT_EQ(multi.cantidadDeProcesosActivos(), 180);
+    for (int i = 0; i < 200; i++) {
+        ASSERT(multi.esPlanificado(i));
+    }
+    multi.reanudarProceso(10);
+    multi.eliminarProceso(11);
+    ASSERT_EQ(multi.esPlanificado(11), false);
+    ASSERT_EQ(multi.cantidadDeProcesosActivos(), 180);
+
+    multi.detener();
+    ASSERT_EQ(multi.ejecutarSiguienteProceso(0, [](const int&) {}), false);
+    multi.reanudar();
+    ASSERT_EQ(multi.ejecutarSiguienteProceso(0, [](const int&) {}), true);
+
+    // Un robo saca a lo sumo 32 procesos de la víctima, aunque tenga muchos
+    PlanificadorMulticore<int> dos(2);
+    for (int i = 0; i < 1000; i++) {
+        dos.agregarProceso(i, 0);
+    }
+    ASSERT(dos.ejecutarSiguienteProceso(1, [](const int&) {}));
+    int robados = 0;
+    for (int i = 0; i < 1000; i++) {
+        robados += dos.trabajadorDe(i) == 1 ? 1 : 0;
+    }
+    ASSERT_EQ(robados, 32);
+    ASSERT_EQ((int)dos.cantidadDeRobos(), 1);
+}
+
+/**
+ * Saltear k turnos equivale a k llamadas a ejecutarSiguienteProceso, y
+ * los próximos procesos se pueden ver sin ejecutarlos.
+ */
+void avanzarVarios() {
+    PlanificadorRR<int> planificador = {0, 1, 2, 3, 4, 5, 6};
+    planificador.pausarProceso(2);
+    planificador.pausarProceso(5);
+    PlanificadorRR<int> paso(planificador);
+    for (long k = 0; k < 12; k++) {
+        PlanificadorRR<int> salto(planificador);
+        salto.ejecutarSiguientes(k);
+        ASSERT(salto == paso);
+        paso.ejecutarSiguienteProceso();
+    }
+    planificador.ejecutarSiguientes(1000000003);
+    ASSERT_EQ(planificador.procesoEjecutado(), 4);
+
+    int proximos[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+    int* fin = planificador.proximosProcesos(7, proximos);
+    ASSERT(fin == proximos + 7);
+    ASSERT_EQ(proximos[0], 4);
+    ASSERT_EQ(proximos[1], 6);
+    ASSERT_EQ(proximos[2], 0);
+    ASSERT_EQ(proximos[4], 3);
+    ASSERT_EQ(proximos[5], 4);
+    ASSERT_EQ(proximos[6], 6);
+    ASSERT_EQ(proximos[7], -1);
+    ASSERT_EQ(planificador.procesoEjecutado(), 4);
+
+    vector<int> vistos;
+    planificador.proximosProcesos(3, back_inserter(vistos));
+    ASSERT_EQ((int)vistos.size(), 3);
+    ASSERT_EQ(vistos[2], 0);
+
+    // Saltos y páginas contra avanzar de a uno y recortar el texto entero,
+    // mientras el árbol de posiciones se rearma al copiar y reubicar
+    PlanificadorRR<int> azaroso;
+    unsigned azar = 777;
+    for (int i = 0; i < 6000; i++) {
+        azar = azar * 1103515245 + 12345;
+        int pid = (azar >> 8) % 300;
+        int operacion = (azar >> 20) % 10;
+        if (!azaroso.esPlanificado(pid)) {
+            azaroso.agregarProceso(pid);
+        } else if (operacion == 0) {
+            azaroso.eliminarProceso(pid);
+        } else if (operacion == 1) {
+            azaroso.eliminarProcesoDiferido(pid);
+            azaroso.compactar(1);
+        } else if (operacion < 5 && azaroso.estaActivo(pid)) {
+            azaroso.pausarProceso(pid);
+        } else if (operacion < 7 && !azaroso.estaActivo(pid)) {
+            azaroso.reanudarProceso(pid);
+        } else if (operacion == 7) {
+            PlanificadorRR<int> copia(azaroso);
+            copia.agregarProceso(-1);
+            copia.eliminarProceso(-1);
+            azaroso = std::move(copia);
+        } else if (operacion == 8 && i % 50 == 0) {
+            azaroso.reubicarEnOrden();
+        }
+        if (azaroso.hayProcesosActivos()) {
+            long k = (azar >> 4) % (3 * azaroso.cantidadDeProcesosActivos() + 2);
+            PlanificadorRR<int> salto(azaroso);
+            PlanificadorRR<int> paso(azaroso);
+            salto.ejecutarSiguientes(k);
+            for (long j = 0; j < k % azaroso.cantidadDeProcesosActivos(); j++) {
+                paso.ejecutarSiguienteProceso();
+            }
+            ASSERT_EQ(salto.procesoEjecutado(), paso.procesoEjecutado());
+            azaroso.ejecutarSiguientes(k);
+        }
+        if (azaroso.hayProcesos() && i % 7 == 0) {
+            string entero = to_s(azaroso);
+            vector<string> entradas;
+            size_t desde = 1;
+            for (size_t coma; (coma = entero.find(", ", desde)) != string::npos; desde = coma + 2) {
+                entradas.push_back(entero.substr(desde, coma - desde));
+            }
+            entradas.push_back(entero.substr(desde, entero.size() - 1 - desde));
+            int inicio = (azar >> 3) % azaroso.cantidadDeProcesos();
+            string esperado = "[";
+            for (int j = inicio; j < inicio + 3 && j < (int)entradas.size(); j++) {
+                esperado += (j > inicio ? ", " : "") + entradas[j];
+            }
+            ostringstream pagina;
+            azaroso.mostrarPlanificadorRR(pagina, inicio, 3);
+            ASSERT_EQ(pagina.str(), esperado + "]");
+        }
+    }
+}
+
+void estadisticas() {
+    typedef PlanificadorRR<int, hash<int>, allocator<int>, EstadisticasAtomicas> Medido;
+    ASSERT(sizeof(PlanificadorRR<int>) == sizeof(PlanificadorRR<int, hash<int>, allocator<int>, SinEstadisticas>));
+    ASSERT_EQ((int)PlanificadorRR<int>().estadisticas().llamadas[OP_AGREGAR], 0);
+
+    Medido planificador;
+    for (int i = 0; i < 5; i++) {
+        planificador.agregarProceso(i);
+    }
+    planificador.pausarProceso(2);
+    planificador.ejecutarSiguienteProceso();
+    planificador.ejecutarSiguienteProceso();
+    ASSERT(planificador.esPlanificado(3));
+    planificador.eliminarProceso(0);
+    planificador.reanudarProceso(2);
+
+    InstantaneaDeEstadisticas foto = planificador.estadisticas();
+    ASSERT_EQ((int)foto.llamadas[OP_AGREGAR], 5);
+    ASSERT_EQ((int)foto.llamadas[OP_PAUSAR], 1);
+    ASSERT_EQ((int)foto.llamadas[OP_REANUDAR], 1);
+    ASSERT_EQ((int)foto.llamadas[OP_EJECUTAR], 2);
+    ASSERT_EQ((int)foto.llamadas[OP_BUSCAR], 1);
+    ASSERT_EQ((int)foto.llamadas[OP_ELIMINAR], 1);
+    ASSERT_EQ((int)foto.llamadas[OP_SEPARAR], 0);
+    ASSERT_EQ((int)foto.asignaciones, 5);
+    ASSERT_EQ((int)foto.liberaciones, 1);
+    ASSERT(foto.saltos > 0);
+    for (int op = 0; op < CANTIDAD_DE_OPERACIONES; op++) {
+        uint64_t medidas = 0;
+        for (int i = 0; i < InstantaneaDeEstadisticas::CUBETAS; i++) {
+            medidas += foto.latencias[op][i];
+        }
+        ASSERT(medidas == foto.llamadas[op]);
+    }
+
+    // La copia empieza de cero y la separación se cuenta en ella
+    Medido copia(planificador);
+    ASSERT_EQ((int)planificador.estadisticas().llamadas[OP_COPIAR], 1);
+    ASSERT_EQ((int)copia.estadisticas().llamadas[OP_COPIAR], 0);
+    copia.pausarProceso(4);
+    ASSERT_EQ((int)copia.estadisticas().llamadas[OP_SEPARAR], 1);
+    ASSERT_EQ((int)copia.estadisticas().asignaciones, 4);
+    ASSERT_EQ(string(nombreDeOperacion(OP_SEPARAR)), "separar");
+}
+
+void trazas() {
+    ostringstream salida;
+    {
+        PlanificadorRegistrado<int> registrado(&salida);
+        for (int i = 0; i < 6; i++) {
+            registrado.agregarProceso(i * 1000 - 2000);
+        }
+        registrado.ejecutarSiguienteProceso();
+        registrado.ejecutarSiguienteProceso();
+        registrado.pausarProceso(0);
+        registrado.eliminarProceso(-2000);
+        registrado.ejecutarSiguienteProceso();
+        registrado.detener();
+        registrado.reanudar();
+        registrado.reanudarProceso(0);
+        registrado.pausarProceso(3000);
+        registrado.detener();
+    }
+    string traza = salida.str();
+    const unsigned char* datos = (const unsigned char*)traza.data();
+
+    PlanificadorRR<int> reproducido;
+    ResultadoDeReproduccion resultado = reproducirTraza(datos, traza.size(), reproducido);
+    ASSERT(resultado.cabeceraValida);
+    ASSERT_EQ((int)resultado.operaciones, 16);
+    ASSERT(coincideConEstadoFinal(resultado, reproducido));
+    ASSERT(reproducido.detenido());
+    ASSERT_EQ(reproducido.procesoEjecutado(), 2000);
+    ASSERT_EQ(reproducido.cantidadDeProcesosActivos(), 4);
+
+    PlanificadorRRIndexado<int> indexado;
+    ASSERT(coincideConEstadoFinal(reproducirTraza(datos, traza.size(), indexado), indexado));
+
+    // Un estado distinto no coincide
+    reproducido.reanudar();
+    reproducido.ejecutarSiguienteProceso();
+    reproducido.detener();
+    ASSERT(!coincideConEstadoFinal(resultado, reproducido));
+
+    // Una traza cortada se aplica hasta el último registro completo
+    PlanificadorRR<int> cortado;
+    resultado = reproducirTraza(datos, 13, cortado);
+    ASSERT(resultado.estadoFinal == NULL);
+    ASSERT_EQ((int)resultado.operaciones, 3);
+    ASSERT_EQ(cortado.cantidadDeProcesos(), 3);
+    PlanificadorRR<int> invalido;
+    ASSERT(!reproducirTraza(datos + 1, traza.size() - 1, invalido).cabeceraValida);
+
+    // Sin salida no se graba nada
+    PlanificadorRegistrado<int> sinTraza;
+    sinTraza.agregarProceso(7);
+    sinTraza.ejecutarSiguienteProceso();
+    ASSERT_EQ(sinTraza.planificador().procesoEjecutado(), 7);
+}
+
+/**
+ * Allocator que lleva en un contador compartido cuántos elementos tiene
+ * pedidos, para ver de qué asignador salen los nodos.
+ */
+template<typename T>
+struct AsignadorContado {
+    typedef T value_type;
+    int* pedidos;
+    explicit AsignadorContado(int* pedidos = NULL) : pedidos(pedidos) {}
+    template<typename U>
+    AsignadorContado(const AsignadorContado<U>& otro) : pedidos(otro.pedidos) {}
+    T* allocate(size_t n) {
+        if (pedidos != NULL) {
+            *pedidos += n;
+        }
+        return allocator<T>().allocate(n);
+    }
+    void deallocate(T* liberado, size_t n) {
+        if (pedidos != NULL) {
+            *pedidos -= n;
+        }
+        allocator<T>().deallocate(liberado, n);
+    }
+    bool operator==(const AsignadorContado<T>& otro) const { return pedidos == otro.pedidos; }
+    bool operator!=(const AsignadorContado<T>& otro) const { return pedidos != otro.pedidos; }
+};
+
+void guardarYCargar() {
+    const char* ruta = "tests2_instantanea.bin";
+    PlanificadorRR<int> planificador;
+    for (int i = 0; i < 200; i++) {
+        planificador.agregarProceso(i * 7);
+    }
+    for (int i = 0; i < 200; i += 3) {
+        planificador.pausarProceso(i * 7);
+    }
+    planificador.ejecutarSiguientes(50);
+    planificador.detener();
+    ASSERT(planificador.guardar(ruta));
+
+    PlanificadorRR<int> cargado;
+    cargado.agregarProceso(-1);
+    ASSERT(cargado.cargar(ruta));
+    ASSERT(cargado == planificador);
+    ASSERT(cargado.detenido());
+    ASSERT_EQ(cargado.procesoEjecutado(), planificador.procesoEjecutado());
+    ASSERT_EQ(cargado.cantidadDeProcesosActivos(), planificador.cantidadDeProcesosActivos());
+    ASSERT(!cargado.esPlanificado(-1));
+    ASSERT(cargado.huella() == planificador.huella());
+    cargado.reanudar();
+    cargado.eliminarProceso(cargado.procesoEjecutado());
+    cargado.ejecutarSiguienteProceso();
+
+    // Los nodos cargados salen del asignador del planificador
+    int pedidos = 0;
+    {
+        PlanificadorRR<int, hash<int>, AsignadorContado<int> > contado((AsignadorContado<int>(&pedidos)));
+        contado.agregarProceso(-1);
+        ASSERT(contado.cargar(ruta));
+        ASSERT_EQ(pedidos, 200);
+        contado.agregarProceso(-1);
+        ASSERT_EQ(pedidos, 201);
+    }
+    ASSERT_EQ(pedidos, 0);
+
+    // Todos pausados: el actual sigue siendo el mismo
+    PlanificadorRR<int> pausados{1, 2, 3};
+    pausados.ejecutarSiguienteProceso();
+    pausados.pausarProceso(3);
+    pausados.pausarProceso(1);
+    pausados.pausarProceso(2);
+    ASSERT(pausados.guardar(ruta));
+    ASSERT(cargado.cargar(ruta));
+    ASSERT(cargado == pausados);
+    ASSERT_EQ(to_s(cargado), to_s(pausados));
+
+    PlanificadorRR<string> nombres{"init", "", "sshd"};
+    nombres.pausarProceso("");
+    ASSERT(nombres.guardar(ruta));
+    PlanificadorRR<string> nombresCargados;
+    ASSERT(nombresCargados.cargar(ruta));
+    ASSERT(nombresCargados == nombres);
+
+    // Un archivo cortado o que no es una instantánea no cambia nada
+    ASSERT(planificador.guardar(ruta));
+    string contenido;
+    {
+        ifstream entrada(ruta, ios::binary);
+        contenido.assign(istreambuf_iterator<char>(entrada), istreambuf_iterator<char>());
+    }
+    {
+        ofstream salida(ruta, ios::binary | ios::trunc);
+        salida.write(contenido.data(), contenido.size() - 1);
+    }
+    string antes = to_s(cargado);
+    ASSERT(!cargado.cargar(ruta));
+    ASSERT(!cargado.cargar("no_existe.bin"));
+    ASSERT_EQ(to_s(cargado), antes);
+    remove(ruta);
+}
+
+void mostrarPaginas() {
+    PlanificadorRR<int> planificador{10, -20, 30, 40, 50};
+    planificador.pausarProceso(30);
+    planificador.ejecutarSiguienteProceso();
+    string completo = "[-20*, 30 (i), 40, 50, 10]";
+    ASSERT_EQ(to_s(planificador), completo);
+
+    ostringstream pagina;
+    planificador.mostrarPlanificadorRR(pagina, 3, 10);
+    ASSERT_EQ(pagina.str(), "[50, 10]");
+    pagina.str("");
+    planificador.mostrarPlanificadorRR(pagina, 0, 2);
+    ASSERT_EQ(pagina.str(), "[-20*, 30 (i)]");
+    pagina.str("");
+    planificador.mostrarPlanificadorRR(pagina, 7, 2);
+    ASSERT_EQ(pagina.str(), "[]");
+
+    // Con formato especial en el ostream se usa <<
+    pagina.str("");
+    pagina << hex;
+    planificador.mostrarPlanificadorRR(pagina, 2, 1);
+    ASSERT_EQ(pagina.str(), "[28]");
+
+    char buffer[64];
+    char* fin = planificador.mostrarEn(buffer, buffer + sizeof(buffer));
+    ASSERT(fin != NULL);
+    ASSERT_EQ(string(buffer, fin), completo);
+    fin = planificador.mostrarEn(buffer, buffer + completo.size());
+    ASSERT(fin != NULL);
+    ASSERT(planificador.mostrarEn(buffer, buffer + completo.size() - 1) == NULL);
+    fin = planificador.mostrarEn(buffer, buffer + sizeof(buffer), 1, 2);
+    ASSERT_EQ(string(buffer, fin), "[30 (i), 40]");
+
+    // Lo guardado se regenera sólo cuando el planificador cambia
+    const string& mostrado = planificador.mostrado();
+    ASSERT_EQ(mostrado, completo);
+    ASSERT(&planificador.mostrado() == &mostrado);
+    planificador.ejecutarSiguienteProceso();
+    ASSERT_EQ(planificador.mostrado(), "[40*, 50, 10, -20, 30 (i)]");
+    PlanificadorRR<int> copia(planificador);
+    copia.reanudarProceso(30);
+    ASSERT_EQ(planificador.mostrado(), "[40*, 50, 10, -20, 30 (i)]");
+    ASSERT_EQ(copia.mostrado(), "[40*, 50, 10, -20, 30]");
+    planificador = std::move(copia);
+    ASSERT_EQ(planificador.mostrado(), "[40*, 50, 10, -20, 30]");
+    ASSERT_EQ(copia.mostrado(), "[]");
+
+    PlanificadorRR<string> nombres{"init", "sshd"};
+    nombres.pausarProceso("init");
+    ASSERT_EQ(nombres.mostrado(), "[sshd*, init (i)]");
+    pagina.str("");
+    nombres.mostrarPlanificadorRR(pagina, 1, 1);
+    ASSERT_EQ(pagina.str(), "[init (i)]");
+}
+
+void iteradores() {
+    PlanificadorRR<int> vacio;
+    ASSERT(vacio.begin() == vacio.end());
+    ASSERT(vacio.procesosActivos().empty());
+
+    PlanificadorRR<int> planificador{1, 2, 3, 4, 5, 6};
+    planificador.ejecutarSiguienteProceso();
+    planificador.pausarProceso(3);
+    planificador.pausarProceso(4);
+    planificador.pausarProceso(6);
+
+    vector<int> todos(planificador.begin(), planificador.end());
+    ASSERT_EQ((int)todos.size(), 6);
+    ASSERT_EQ(todos[0], 2);
+    ASSERT_EQ(todos[5], 1);
+
+    int pausados = 0;
+    for (PlanificadorRR<int>::const_iterator it = planificador.begin(); it != planificador.end(); it++) {
+        pausados += it.pausado();
+    }
+    ASSERT_EQ(pausados, 3);
+
+    vector<int> activos;
+    for (const int& pid : planificador.procesosActivos()) {
+        activos.push_back(pid);
+    }
+    ASSERT_EQ((int)activos.size(), 3);
+    ASSERT_EQ(activos[0], 2);
+    ASSERT_EQ(activos[1], 5);
+    ASSERT_EQ(activos[2], 1);
+    ASSERT_EQ(planificador.procesosActivos().size(), 3);
+    ASSERT(find(planificador.begin(), planificador.end(), 4) != planificador.end());
+    ASSERT(find(planificador.procesosActivos().begin(), planificador.procesosActivos().end(), 4)
+        == planificador.procesosActivos().end());
+    ASSERT_EQ((int)count_if(planificador.begin(), planificador.end(), [](int pid) { return pid % 2 == 0; }), 3);
+
+    // Todos pausados: la vista de activos está vacía
+    planificador.pausarSi([](const int&) { return true; });
+    ASSERT(planificador.procesosActivos().begin() == planificador.procesosActivos().end());
+    ASSERT_EQ((int)distance(planificador.begin(), planificador.end()), 6);
+
+    PlanificadorRR<string> nombres{"init", "sshd"};
+    ASSERT_EQ((int)nombres.begin()->size(), 4);
+}
+
+/**
+ * El almacenamiento denso da lo mismo que PlanificadorRR en una
+ * secuencia larga de operaciones al azar.
+ */
+void almacenamientoDenso() {
+    PlanificadorSegun<int, AlmacenamientoDenso<200> >::tipo denso;
+    PlanificadorRR<int> enlazado;
+    ASSERT(!denso.esPlanificado(-1));
+    ASSERT(!denso.esPlanificado(201));
+    unsigned azar = 12345;
+    for (int i = 0; i < 20000; i++) {
+        azar = azar * 1103515245 + 12345;
+        int pid = (azar >> 8) % 201;
+        int operacion = (azar >> 20) % 4;
+        if (!enlazado.esPlanificado(pid)) {
+            enlazado.agregarProceso(pid);
+            denso.agregarProceso(pid);
+        } else if (operacion == 0) {
+            enlazado.eliminarProceso(pid);
+            denso.eliminarProceso(pid);
+        } else if (operacion == 1 && enlazado.hayProcesosActivos()) {
+            enlazado.ejecutarSiguienteProceso();
+            denso.ejecutarSiguienteProceso();
+        } else if (enlazado.estaActivo(pid)) {
+            enlazado.pausarProceso(pid);
+            denso.pausarProceso(pid);
+        } else {
+            enlazado.reanudarProceso(pid);
+            denso.reanudarProceso(pid);
+        }
+        ASSERT(denso.esPlanificado(pid) == enlazado.esPlanificado(pid));
+        ASSERT_EQ(denso.cantidadDeProcesosActivos(), enlazado.cantidadDeProcesosActivos());
+        if (i % 97 == 0) {
+            ASSERT_EQ(to_s(denso), to_s(enlazado));
+        }
+    }
+    ASSERT_EQ(to_s(denso), to_s(enlazado));
+    if (denso.hayProcesos()) {
+        ASSERT_EQ(denso.procesoEjecutado(), enlazado.procesoEjecutado());
+    }
+
+    PlanificadorRRDenso<int, 200> copia(denso);
+    ASSERT(copia == denso);
+    copia.detener();
+    ASSERT(!(copia == denso));
+    copia.reanudar();
+    int libre = 0;
+    while (copia.esPlanificado(libre)) {
+        libre++;
+    }
+    copia.agregarProceso(libre);
+    ASSERT(!(copia == denso));
+    ASSERT(!denso.esPlanificado(libre));
+
+    // La referencia al ejecutado no cambia cuando se ejecuta otro
+    const int& ejecutado = copia.procesoEjecutado();
+    int antes = ejecutado;
+    while (copia.esPlanificado(libre)) {
+        libre++;
+    }
+    copia.agregarProceso(libre);
+    copia.ejecutarSiguienteProceso();
+    ASSERT_EQ(ejecutado, antes);
+    ASSERT(copia.procesoEjecutado() != antes);
+
+    PlanificadorRRDenso<unsigned, 64> sinSigno;
+    sinSigno.agregarProceso(64u);
+    sinSigno.agregarProceso(0u);
+    ASSERT(sinSigno.esPlanificado(64u));
+    ASSERT(!sinSigno.esPlanificado(65u));
+    ASSERT(sinSigno.procesoEjecutado() == 64u);
+}
+
+/**
+ * Con las posiciones en orden, el indexado busca el siguiente activo en
+ * el bitmap de pausados y sigue dando lo mismo que el enlazado.
+ */
+void bitmapDePausados() {
+    uint64_t palabras[9] = {~0ull, ~0ull, ~0ull, ~0ull, ~0ull, ~0ull, ~0ull, ~(1ull << 40), ~0ull};
+    ASSERT_EQ((int)buscarCero(palabras, 0, 576), 7 * 64 + 40);
+    ASSERT_EQ((int)buscarCero(palabras, 7 * 64 + 41, 576), 576);
+    ASSERT_EQ((int)buscarCero(palabras, 3, 7 * 64 + 40), 7 * 64 + 40);
+    ASSERT_EQ((int)buscarCero(palabras, 5, 5), 5);
+    ASSERT_EQ((int)contarUnos(palabras, 9), 9 * 64 - 1);
+
+    PlanificadorRRIndexado<int> indexado;
+    PlanificadorRR<int> enlazado;
+    for (int pid = 0; pid < 300; pid++) {
+        indexado.agregarProceso(pid);
+        enlazado.agregarProceso(pid);
+    }
+    ASSERT(indexado.ordenado());
+    unsigned azar = 777;
+    for (int i = 0; i < 20000; i++) {
+        azar = azar * 1103515245 + 12345;
+        int pid = (azar >> 8) % 300;
+        int operacion = (azar >> 20) % 8;
+        if (!enlazado.esPlanificado(pid)) {
+            enlazado.agregarProceso(pid);
+            indexado.agregarProceso(pid);
+        } else if (operacion == 0) {
+            enlazado.eliminarProceso(pid);
+            indexado.eliminarProceso(pid);
+        } else if (operacion == 1) {
+            indexado.reordenar();
+            ASSERT(indexado.ordenado());
+        } else if (operacion < 5 && enlazado.hayProcesosActivos()) {
+            enlazado.ejecutarSiguienteProceso();
+            indexado.ejecutarSiguienteProceso();
+        } else if (enlazado.estaActivo(pid)) {
+            enlazado.pausarProceso(pid);
+            indexado.pausarProceso(pid);
+        } else if (operacion == 5) {
+            enlazado.reanudarProceso(pid);
+            indexado.reanudarProceso(pid);
+        }
+        ASSERT_EQ(indexado.cantidadDeProcesosActivos(), enlazado.cantidadDeProcesosActivos());
+        if (enlazado.hayProcesos()) {
+            ASSERT_EQ(indexado.procesoEjecutado(), enlazado.procesoEjecutado());
+        }
+        if (i % 97 == 0) {
+            ASSERT_EQ(to_s(indexado), to_s(enlazado));
+        }
+    }
+    ASSERT_EQ(to_s(indexado), to_s(enlazado));
+
+    PlanificadorRRIndexado<int> copia(indexado);
+    copia.reordenar();
+    ASSERT(copia == indexado);
+    ASSERT_EQ(to_s(copia), to_s(indexado));
+}
+
+/**
+ * Eliminar en diferido da lo mismo que eliminar, y los nodos se liberan
+ * después, de a tandas, al compactar.
+ */
+void eliminacionDiferida() {
+    PlanificadorRR<int, hash<int>, allocator<int>, EstadisticasAtomicas> diferido;
+    PlanificadorRR<int> inmediato;
+    for (int pid = 0; pid < 10; pid++) {
+        diferido.agregarProceso(pid);
+        inmediato.agregarProceso(pid);
+    }
+    diferido.pausarProceso(3);
+    inmediato.pausarProceso(3);
+    int eliminados[] = {0, 3, 5, 1};
+    for (int i = 0; i < 4; i++) {
+        diferido.eliminarProcesoDiferido(eliminados[i]);
+        inmediato.eliminarProceso(eliminados[i]);
+        ASSERT(!diferido.esPlanificado(eliminados[i]));
+        ASSERT_EQ(to_s(diferido), to_s(inmediato));
+    }
+    ASSERT_EQ(diferido.cantidadDeProcesos(), 6);
+    ASSERT_EQ(diferido.cantidadDeProcesosActivos(), 6);
+    ASSERT_EQ(diferido.procesoEjecutado(), 2);
+    ASSERT_EQ(diferido.cantidadDeProcesosPorCompactar(), 4);
+    ASSERT_EQ((int)diferido.estadisticas().liberaciones, 0);
+
+    // Un pid eliminado puede volver antes de compactar
+    diferido.agregarProceso(5);
+    inmediato.agregarProceso(5);
+    ASSERT_EQ(diferido.compactar(3), 3);
+    ASSERT_EQ(diferido.cantidadDeProcesosPorCompactar(), 1);
+    ASSERT_EQ((int)diferido.estadisticas().liberaciones, 3);
+    ASSERT(diferido.esPlanificado(5));
+    ASSERT_EQ(diferido.compactar(10), 1);
+    ASSERT(diferido.esPlanificado(5));
+    ASSERT(!diferido.esPlanificado(0));
+    ASSERT_EQ(diferido.compactar(10), 0);
+    ASSERT_EQ(to_s(diferido), to_s(inmediato));
+
+    // Compartidos con una copia, los muertos esperan a que se separen
+    diferido.eliminarProcesoDiferido(7);
+    PlanificadorRR<int, hash<int>, allocator<int>, EstadisticasAtomicas> copia(diferido);
+    ASSERT_EQ(diferido.compactar(10), 0);
+    copia.eliminarProcesoDiferido(8);
+    ASSERT_EQ(copia.cantidadDeProcesosPorCompactar(), 1);
+    ASSERT_EQ(diferido.compactar(10), 1);
+    ASSERT(diferido.esPlanificado(8));
+    ASSERT(!copia.esPlanificado(8));
+
+    diferido.eliminarProcesoDiferido(8);
+    diferido.eliminarProcesoDiferido(9);
+    PlanificadorRR<int, SinHash> sinIndice;
+    sinIndice.agregarProceso(1);
+    sinIndice.agregarProceso(2);
+    sinIndice.eliminarProcesoDiferido(1);
+    ASSERT(!sinIndice.esPlanificado(1));
+    ASSERT_EQ(to_s(sinIndice), "[2*]");
+}
+
+/**
+ * Las operaciones y los cambios de proceso llegan en orden al buffer de
+ * eventos; lleno, pisa a los más viejos o descarta los nuevos.
+ */
+void eventosDelPlanificador() {
+    typedef BufferDeEventos<int>::Evento Evento;
+    BufferDeEventos<int> buffer(8, DESCARTAR_NUEVOS);
+    PlanificadorConEventos<int> planificador(&buffer);
+    planificador.agregarProceso(1);
+    planificador.agregarProceso(2);
+    planificador.ejecutarSiguienteProceso();
+    planificador.pausarProceso(2);
+    planificador.eliminarProceso(1);
+    Evento leidos[16];
+    ASSERT_EQ((int)buffer.consumir(leidos, 16), 8);
+    int tipos[] = {EVENTO_AGREGAR, EVENTO_CAMBIO_DE_PROCESO, EVENTO_AGREGAR, EVENTO_CAMBIO_DE_PROCESO,
+        EVENTO_PAUSAR, EVENTO_CAMBIO_DE_PROCESO, EVENTO_ELIMINAR, EVENTO_CAMBIO_DE_PROCESO};
+    int pids[] = {1, 1, 2, 2, 2, 1, 1, 2};
+    for (int i = 0; i < 8; i++) {
+        ASSERT_EQ((int)leidos[i].tipo, tipos[i]);
+        ASSERT_EQ(leidos[i].pid, pids[i]);
+        ASSERT(i == 0 || leidos[i].instante >= leidos[i - 1].instante);
+    }
+    ASSERT(leidos[4].instante == leidos[5].instante);
+    ASSERT_EQ((int)buffer.consumir(leidos, 16), 0);
+
+    for (int i = 0; i < 10; i++) {
+        planificador.agregarProceso(10 + i);
+    }
+    ASSERT_EQ((int)buffer.perdidos(), 3);
+    ASSERT_EQ((int)buffer.consumir(leidos, 3), 3);
+    ASSERT_EQ((int)buffer.consumir(leidos, 16), 5);
+    ASSERT_EQ(leidos[4].pid, 16);
+
+    BufferDeEventos<int> circular(8, PISAR_MAS_VIEJOS);
+    PlanificadorConEventos<int> pisado(&circular);
+    for (int i = 0; i < 20; i++) {
+        pisado.agregarProceso(i);
+    }
+    ASSERT_EQ((int)circular.consumir(leidos, 16), 8);
+    ASSERT_EQ((int)circular.perdidos(), 13);
+    ASSERT_EQ(leidos[0].pid, 12);
+    ASSERT_EQ(leidos[7].pid, 19);
+
+    // El pid puede ser una referencia al proceso que se elimina
+    pisado.eliminarProceso(pisado.planificador().procesoEjecutado());
+    ASSERT_EQ((int)circular.consumir(leidos, 16), 2);
+    ASSERT_EQ((int)leidos[0].tipo, EVENTO_ELIMINAR);
+    ASSERT_EQ(leidos[0].pid, 0);
+    ASSERT_EQ((int)leidos[1].tipo, EVENTO_CAMBIO_DE_PROCESO);
+    ASSERT_EQ(leidos[1].pid, 1);
+
+    // Un consumidor en otro hilo ve los cambios en orden, y los que no ve
+    // se cuentan como perdidos
+    BufferDeEventos<int> compartido(64, PISAR_MAS_VIEJOS);
+    PlanificadorConEventos<int> productor(&compartido);
+    for (int i = 0; i < 100; i++) {
+        productor.agregarProceso(i);
+    }
+    while (compartido.consumir(leidos, 16) > 0) {
+    }
+    uint64_t antes = compartido.perdidos();
+    const int ejecuciones = 200000;
+    long consumidos = 0;
+    bool enOrden = true;
+    atomic<bool> terminado(false);
+    thread consumidor([&]() {
+        Evento tanda[32];
+        uint64_t ultimo = 0;
+        for (;;) {
+            bool fin = terminado.load();
+            size_t n = compartido.consumir(tanda, 32);
+            for (size_t i = 0; i < n; i++) {
+                enOrden = enOrden && tanda[i].tipo == EVENTO_CAMBIO_DE_PROCESO && tanda[i].instante >= ultimo;
+                ultimo = tanda[i].instante;
+            }
+            consumidos += n;
+            if (fin && n == 0) {
+                break;
+            }
+        }
+    });
+    for (int i = 0; i < ejecuciones; i++) {
+        productor.ejecutarSiguienteProceso();
+    }
+    terminado = true;
+    consumidor.join();
+    ASSERT(enOrden);
+    ASSERT_EQ((int)(consumidos + compartido.perdidos() - antes), ejecuciones);
+}
+
+/**
+ * Los grupos se turnan, y pausar un grupo saca a todos sus procesos de
+ * la ejecución sin cambiar el estado de cada uno.
+ */
+void gruposDeProcesos() {
+    PlanificadorPorGrupos<int> planificador;
+    planificador.agregarProceso(1, 10);
+    planificador.agregarProceso(2, 10);
+    planificador.agregarProceso(3, 20);
+    planificador.agregarProceso(4, 30);
+    ASSERT_EQ(planificador.cantidadDeGrupos(), 3);
+    ASSERT_EQ(planificador.grupoDe(3), 20);
+    ASSERT_EQ(to_s(planificador), "[1*: 10, 2: 10, 3: 20, 4: 30]");
+    // Un único Round Robin: el tamaño del grupo no cambia los turnos
+    int esperados[] = {1, 2, 3, 4, 1, 2, 3};
+    for (int i = 0; i < 7; i++) {
+        ASSERT_EQ(planificador.procesoEjecutado(), esperados[i]);
+        planificador.ejecutarSiguienteProceso();
+    }
+
+    planificador.pausarProceso(2);
+    planificador.pausarGrupo(10);
+    ASSERT_EQ(planificador.procesoEjecutado(), 4);
+    ASSERT(planificador.grupoPausado(10));
+    ASSERT(planificador.estaActivo(1));
+    ASSERT(!planificador.esEjecutable(1));
+    ASSERT_EQ(planificador.cantidadDeProcesosActivos(), 2);
+    planificador.ejecutarSiguienteProceso();
+    ASSERT_EQ(planificador.procesoEjecutado(), 3);
+    planificador.ejecutarSiguienteProceso();
+    ASSERT_EQ(planificador.procesoEjecutado(), 4);
+
+    planificador.pausarGrupo(20);
+    planificador.pausarProceso(4);
+    ASSERT(!planificador.hayProcesosActivos());
+    ASSERT_EQ(planificador.cantidadDeProcesosActivos(), 0);
+    planificador.reanudarGrupo(10);
+    ASSERT(planificador.hayProcesosActivos());
+    ASSERT_EQ(planificador.procesoEjecutado(), 1);
+    ASSERT_EQ(planificador.cantidadDeProcesosActivos(), 1);
+    ASSERT_EQ(to_s(planificador), "[1*: 10, 2 (i): 10, 3: 20 (i), 4 (i): 30]");
+
+    planificador.reanudarProceso(2);
+    planificador.reanudarGrupo(20);
+    planificador.eliminarProceso(4);
+    ASSERT(!planificador.existeGrupo(30));
+    ASSERT_EQ(planificador.cantidadDeProcesos(), 3);
+    ASSERT_EQ(planificador.cantidadDeProcesosActivos(), 3);
+    int despues[] = {1, 2, 3, 1, 2};
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(planificador.procesoEjecutado(), despues[i]);
+        planificador.ejecutarSiguienteProceso();
+    }
+    ASSERT(!planificador.esPlanificado(4));
+    planificador.agregarProceso(4, 20);
+    ASSERT_EQ(planificador.grupoDe(4), 20);
+
+    // Pausar un grupo grande no recorre sus procesos
+    PlanificadorPorGrupos<int> grande;
+    for (int i = 0; i < 10000; i++) {
+        grande.agregarProceso(i, i % 2);
+    }
+    grande.pausarGrupo(0);
+    ASSERT_EQ(grande.cantidadDeProcesosActivos(), 5000);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(grande.procesoEjecutado() % 2, 1);
+        grande.ejecutarSiguienteProceso();
+    }
+    grande.reanudarGrupo(0);
+    ASSERT_EQ(grande.cantidadDeProcesosActivos(), 10000);
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_EQ(grande.procesoEjecutado(), (i + 201) % 10000);
+        grande.ejecutarSiguienteProceso();
+    }
+
+    // Contra un PlanificadorRR que tiene activos sólo a los ejecutables. El
+    // 0 está solo en un grupo que nunca se pausa, así que siempre hay
+    // alguno ejecutable y los actuales coinciden.
+    PlanificadorPorGrupos<int> agrupado;
+    PlanificadorRR<int> referencia;
+    map<int, vector<int> > miembros;
+    set<int> pausados;
+    agrupado.agregarProceso(0, 0);
+    referencia.agregarProceso(0);
+    unsigned azar = 2424;
+    for (int i = 0; i < 20000; i++) {
+        azar = azar * 1103515245 + 12345;
+        int pid = 1 + (azar >> 8) % 60;
+        int g = 1 + (azar >> 4) % 4;
+        int operacion = (azar >> 20) % 8;
+        if (operacion == 0) {
+            if (pausados.count(g)) {
+                agrupado.reanudarGrupo(g);
+                pausados.erase(g);
+                for (size_t j = 0; j < miembros[g].size(); j++) {
+                    if (agrupado.estaActivo(miembros[g][j])) {
+                        referencia.reanudarProceso(miembros[g][j]);
+                    }
+                }
+            } else if (agrupado.existeGrupo(g)) {
+                agrupado.pausarGrupo(g);
+                pausados.insert(g);
+                for (size_t j = 0; j < miembros[g].size(); j++) {
+                    if (agrupado.estaActivo(miembros[g][j])) {
+                        referencia.pausarProceso(miembros[g][j]);
+                    }
+                }
+            }
+        } else if (!agrupado.esPlanificado(pid)) {
+            agrupado.agregarProceso(pid, g);
+            referencia.agregarProceso(pid);
+            miembros[g].push_back(pid);
+            if (pausados.count(g)) {
+                referencia.pausarProceso(pid);
+            }
+        } else if (operacion == 1) {
+            int suyo = agrupado.grupoDe(pid);
+            agrupado.eliminarProceso(pid);
+            referencia.eliminarProceso(pid);
+            miembros[suyo].erase(find(miembros[suyo].begin(), miembros[suyo].end(), pid));
+            if (!agrupado.existeGrupo(suyo)) {
+                pausados.erase(suyo);
+            }
+        } else if (operacion == 2 && agrupado.estaActivo(pid)) {
+            if (agrupado.esEjecutable(pid)) {
+                referencia.pausarProceso(pid);
+            }
+            agrupado.pausarProceso(pid);
+        } else if (operacion == 3 && !agrupado.estaActivo(pid)) {
+            agrupado.reanudarProceso(pid);
+            if (agrupado.esEjecutable(pid)) {
+                referencia.reanudarProceso(pid);
+            }
+        } else {
+            agrupado.ejecutarSiguienteProceso();
+            referencia.ejecutarSiguienteProceso();
+        }
+        ASSERT_EQ(agrupado.procesoEjecutado(), referencia.procesoEjecutado());
+        ASSERT_EQ(agrupado.cantidadDeProcesosActivos(), referencia.cantidadDeProcesosActivos());
+    }
+}
+
+/**
+ * Los procesos pausados por una cantidad de ticks despiertan justo a
+ * tiempo, también los que pasan por los niveles altos de la rueda.
+ */
+void pausasTemporizadas() {
+    PlanificadorTemporizado<int> temporizado;
+    temporizado.agregarProceso(1);
+    temporizado.agregarProceso(2);
+    temporizado.agregarProceso(3);
+    temporizado.pausarPor(2, 3);
+    temporizado.pausarPor(3, 100);
+    ASSERT_EQ(to_s(temporizado.planificador()), "[1*, 2 (i), 3 (i)]");
+    ASSERT_EQ((int)temporizado.ticksParaDespertar(3), 100);
+    temporizado.tick();
+    temporizado.tick();
+    ASSERT(temporizado.estaDormido(2));
+    temporizado.tick();
+    ASSERT(!temporizado.estaDormido(2));
+    ASSERT_EQ(to_s(temporizado.planificador()), "[1*, 2, 3 (i)]");
+    temporizado.avanzarTiempo(96);
+    ASSERT(temporizado.estaDormido(3));
+    temporizado.avanzarTiempo(1);
+    ASSERT(!temporizado.estaDormido(3));
+    ASSERT_EQ((int)temporizado.tiempo(), 100);
+    temporizado.pausarPor(1, 5);
+    temporizado.reanudarProceso(1);
+    ASSERT_EQ(temporizado.cantidadDeDormidos(), 0);
+    temporizado.avanzarTiempo(1000000);
+    ASSERT_EQ(to_s(temporizado.planificador()), "[2*, 3, 1]");
+
+    // Contra un planificador que despierta a mano a los que vencen. El 0
+    // nunca duerme, así que el orden en que despiertan no cambia nada.
+    PlanificadorTemporizado<int> rueda;
+    PlanificadorRR<int> referencia;
+    vector<uint64_t> vence(101, 0);
+    uint64_t ahora = 0;
+    rueda.agregarProceso(0);
+    referencia.agregarProceso(0);
+    uint64_t largos[] = {1, 2, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 16777215, 16777216, 20000000};
+    unsigned azar = 4242;
+    for (int i = 0; i < 30000; i++) {
+        azar = azar * 1103515245 + 12345;
+        int pid = 1 + (azar >> 8) % 100;
+        int operacion = (azar >> 20) % 8;
+        if (!referencia.esPlanificado(pid)) {
+            rueda.agregarProceso(pid);
+            referencia.agregarProceso(pid);
+        } else if (operacion == 0) {
+            rueda.eliminarProceso(pid);
+            referencia.eliminarProceso(pid);
+            vence[pid] = 0;
+        } else if (operacion < 4 && referencia.estaActivo(pid)) {
+            uint64_t ticks = operacion == 1 ? largos[(azar >> 4) % 13] : 1 + (azar >> 4) % 300;
+            rueda.pausarPor(pid, ticks);
+            referencia.pausarProceso(pid);
+            vence[pid] = ahora + ticks;
+        } else if (operacion == 4 && !referencia.estaActivo(pid)) {
+            rueda.reanudarProceso(pid);
+            referencia.reanudarProceso(pid);
+            vence[pid] = 0;
+        } else {
+            uint64_t dt = operacion == 5 ? 300000 + (azar >> 4) % 5000000 : (azar >> 4) % 40;
+            rueda.avanzarTiempo(dt);
+            ahora += dt;
+            for (int j = 1; j <= 100; j++) {
+                if (vence[j] != 0 && vence[j] <= ahora) {
+                    referencia.reanudarProceso(j);
+                    vence[j] = 0;
+                }
+            }
+        }
+        rueda.ejecutarSiguienteProceso();
+        referencia.ejecutarSiguienteProceso();
+        ASSERT(rueda.estaDormido(pid) == (vence[pid] != 0));
+        if (i % 53 == 0) {
+            ASSERT_EQ(to_s(rueda.planificador()), to_s(referencia));
+        }
+    }
+    ASSERT_EQ(to_s(rueda.planificador()), to_s(referencia));
+}
+
 int main() {
     RUN_TEST( planificadorVacio );
     RUN_TEST(agregarProcesos);
     RUN_TEST( basic );
     RUN_TEST( copy );
     RUN_TEST( restricted );
+    RUN_TEST( indicePorPid );
+    RUN_TEST( mayoriaPausados );
+    RUN_TEST( poolReubicado );
+    RUN_TEST( almacenamientoIndexado );
+    RUN_TEST( operacionesMasivas );
+    RUN_TEST( copiaCompartida );
+    RUN_TEST( movimientos );
+    RUN_TEST( huellaDeEstado );
+    RUN_TEST( ponderado );
+    RUN_TEST( multinivel );
+    RUN_TEST( pedidosConcurrentes );
+    RUN_TEST( multicore );
+    RUN_TEST( avanzarVarios );
+    RUN_TEST( estadisticas );
+    RUN_TEST( trazas );
+    RUN_TEST( guardarYCargar );
+    RUN_TEST( mostrarPaginas );
+    RUN_TEST( iteradores );
+    RUN_TEST( almacenamientoDenso );
+    RUN_TEST( bitmapDePausados );
+    RUN_TEST( eliminacionDiferida );
+    RUN_TEST( eventosDelPlanificador );
+    RUN_TEST( gruposDeProcesos );
+    RUN_TEST( pausasTemporizadas );
 
     return 0;
 }
\ No newline at end of file